@@ -47,13 +47,17 @@
     #include "xerus/sparseTimesFullContraction.h"
     #include "xerus/sparseTimesFullContraction.h"
     #include "xerus/indexedTensor_tensor_factorisations.h"
+    #include "xerus/compiledContraction.h"
+    #include "xerus/tensorView.h"
     #include "xerus/tensorNetwork.h"
     #include "xerus/contractionHeuristic.h"
     #include "xerus/ttNetwork.h"
     #include "xerus/ttStack.h"
+    #include "xerus/blockTT.h"
 	#include "xerus/performanceData.h"
 	#include "xerus/measurments.h"
     #include "xerus/algorithms/als.h"
+    #include "xerus/algorithms/blockAls.h"
     #include "xerus/algorithms/steepestDescent.h"
     #include "xerus/algorithms/cg.h"
     #include "xerus/algorithms/decompositionAls.h"
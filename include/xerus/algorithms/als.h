@@ -28,6 +28,20 @@
 #include "../performanceData.h"
 
 namespace xerus {
+	
+	namespace internal {
+		/// @brief stacks of contracted components left resp. right of the current position, shared by the ALS variants and the block ALS
+		struct ContractedTNCache {
+			std::vector<Tensor> left, right;
+		};
+		
+		/**
+		* @brief contracts a stack with the components of a single site, i.e. _result(cr_0,...,cr_k) = _stack(r_0,...,r_k) * C_0(r_0,n_0,cr_0) * C_1(r_1,n_0,n_1,cr_1) * ... * C_k(r_k,n_{k-1},cr_k)
+		* @details every step is a single call to contract, preceeded by a reshuffle that moves the modes to be contracted to the end.
+		* right stacks are handled by passing the components with reversed modes.
+		*/
+		void contract_stack_step(Tensor &_result, const Tensor &_stack, const std::vector<Tensor> &_components);
+	}
 
 	/**
 	* @brief Wrapper class for all ALS variants (dmrg etc.)
@@ -41,9 +55,7 @@ namespace xerus {
 		double solve(const TTOperator *_Ap, TTTensor &_x, const TTTensor &_b, size_t _numHalfSweeps, value_t _convergenceEpsilon, PerformanceData &_perfData = NoPerfData) const;
 	
 		struct ALSAlgorithmicData {
-			struct ContractedTNCache {
-				std::vector<Tensor> left, right;
-			};
+			using ContractedTNCache = internal::ContractedTNCache;
 			const ALSVariant &ALS; ///< the algorithm this data belongs to
 			const TTOperator *A; ///< global operator A
 			TTTensor &x; ///< current iterate x
@@ -64,6 +76,7 @@ namespace xerus {
 			value_t energy; ///< current value of the energy residual
 			size_t halfSweepCount; ///< current count of halfSweeps
 			Direction direction; ///< direction of current sweep
+			std::vector<std::vector<Tensor>> orientedOperator; ///< components of A reshuffled once for the operator and rhs stacks, cf. prepare_oriented_operator()
 			
 			/**
 			* @brief Finds the range of notes that need to be optimized and orthogonalizes @a _x properly
@@ -77,6 +90,24 @@ namespace xerus {
 			TensorNetwork localOperatorSlice(size_t _pos);
 			TensorNetwork localRhsSlice(size_t _pos);
 			
+			/**
+			* @brief contracts the operator stack @a _stack with the components at position @a _pos
+			* @details equivalent to contracting with localOperatorSlice(_pos) but uses a fixed sequence of matrix-matrix products
+			* instead of the generic TensorNetwork contraction. @a _direction Increasing extends a left stack, Decreasing a right stack.
+			*/
+			Tensor next_operator_stack(const Tensor &_stack, size_t _pos, Direction _direction) const;
+			
+			/// @brief contracts the right-hand-side stack @a _stack with the components at position @a _pos, cf. next_operator_stack
+			Tensor next_rhs_stack(const Tensor &_stack, size_t _pos, Direction _direction) const;
+			
+			/**
+			* @brief reshuffles every component of A into the orientations used by next_operator_stack and next_rhs_stack
+			* @details these are A(cr, n1, n2, r) for right stacks and, if A is not assumed to be SPD, the transposed A(r, n2, n1, cr) and A(cr, n2, n1, r).
+			* As A does not change during the algorithm this replaces the permutation of the components on every update of a stack.
+			* sets orientedOperator
+			*/
+			void prepare_oriented_operator();
+			
 			/**
 			* @brief prepares the initial stacks for the local operator and local right-hand-side
 			* @details requires optimziedRange
@@ -115,6 +146,7 @@ namespace xerus {
 		bool useResidualForEndCriterion; ///< calculates the residual to decide if the ALS converged. recommended if _perfdata is given. implied if assumeSPD = false
 		bool preserveCorePosition; ///< if true the core will be moved to its original position at the end
 		bool assumeSPD; ///< if true the operator A will be assumed to be symmetric positive definite
+		bool useMixedPrecision; ///< if true the lapack solver factorises the local operators in single precision (Cholesky if assumeSPD is set, LU otherwise) and refines the local solutions to double precision
 		
 		// TODO std::function endCriterion
 		
@@ -122,7 +154,7 @@ namespace xerus {
 		using LocalSolver = std::function<void(const TensorNetwork &, std::vector<Tensor> &, const TensorNetwork &, const ALSAlgorithmicData &)>;
 		LocalSolver localSolver;
 		
-		/// local solver that calls the corresponding lapack routines (LU solver)
+		/// local solver that calls the corresponding lapack routines (least squares solver or Cholesky / LDL^T if assumeSPD is set; with useMixedPrecision a mixed precision Cholesky resp. LU solver)
 		static void lapack_solver(const TensorNetwork &_A, std::vector<Tensor> &_x, const TensorNetwork &_b, const ALSAlgorithmicData &_data);
 		static void ASD_solver(const TensorNetwork &_A, std::vector<Tensor> &_x, const TensorNetwork &_b, const ALSAlgorithmicData &_data);
 		
@@ -134,7 +166,7 @@ namespace xerus {
 			bool _useResidual=false
 		) 
 				: sites(_sites), numHalfSweeps(_numHalfSweeps), convergenceEpsilon(1e-6), 
-				useResidualForEndCriterion(_useResidual), preserveCorePosition(true), assumeSPD(_assumeSPD), localSolver(_localSolver)
+				useResidualForEndCriterion(_useResidual), preserveCorePosition(true), assumeSPD(_assumeSPD), useMixedPrecision(false), localSolver(_localSolver)
 		{
 			REQUIRE(_sites>0, "");
 		}
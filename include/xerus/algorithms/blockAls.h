@@ -0,0 +1,77 @@
+// Xerus - A General Purpose Tensor Library
+// Copyright (C) 2014-2016 Benjamin Huber and Sebastian Wolf. 
+// 
+// Xerus is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+// 
+// Xerus is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+// 
+// You should have received a copy of the GNU Affero General Public License
+// along with Xerus. If not, see <http://www.gnu.org/licenses/>.
+//
+// For further information on Xerus visit https://libXerus.org 
+// or contact us at contact@libXerus.org.
+
+
+/**
+* @file
+* @brief Header file for the block ALS algorithm.
+*/
+
+#pragma once
+
+#include "../ttNetwork.h"
+#include "../blockTT.h"
+
+namespace xerus {
+
+	/**
+	* @brief Wrapper class for the single-site block ALS algorithm for symmetric operators.
+	* @details The iterate is a BlockTT, i.e. all tensors of the block share the components outside of the core. Therefore the stacks of the local operator
+	* (localOperatorCache) and the local operator itself, including its factorisation, are shared by all tensors of the block. Only the (cheap) right-hand-side
+	* stacks are kept per right-hand side. As the block index moves along with the core, the ranks adapt to the whole block by the SVDs that move the core, 
+	* limited by maxRank and roundingEpsilon.
+	* By creating a new object of this class and modifying the member variables, the behaviour of the solver can be modified.
+	*/
+	class BlockALSVariant {
+	public:
+		size_t numHalfSweeps; ///< maximum number of sweeps to perform. set to 0 for infinite
+		value_t convergenceEpsilon; ///< relative change in the energy functional at which the algorithm assumes it is converged
+		size_t maxRank; ///< maximal rank of the iterate
+		value_t roundingEpsilon; ///< relative truncation threshold for the singular values whenever the core is moved
+		
+		/// fully defining constructor. alternatively BlockALSVariants can be created by copying a predefined variant and modifying it
+		BlockALSVariant(size_t _numHalfSweeps, value_t _convergenceEpsilon, size_t _maxRank = std::numeric_limits<size_t>::max(), value_t _roundingEpsilon = EPSILON) 
+			: numHalfSweeps(_numHalfSweeps), convergenceEpsilon(_convergenceEpsilon), maxRank(_maxRank), roundingEpsilon(_roundingEpsilon) {}
+		
+		/**
+		* @brief Solves @f$ A\cdot x_i = b_i @f$ for all right-hand sides at once.
+		* @param _A symmetric positive definite operator to solve for
+		* @param[in,out] _x in: initial guess, out: solution as found by the algorithm. Its block size must equal the number of right-hand sides.
+		* @param _b the right-hand sides
+		* @returns the relative residuals @f$|Ax_i-b_i|/|b_i|@f$ of the final @a _x
+		*/
+		std::vector<value_t> solve(const TTOperator &_A, BlockTT &_x, const std::vector<TTTensor> &_b) const;
+		
+		/**
+		* @brief Approximates the eigenvectors to the blockSize smallest eigenvalues of @a _A.
+		* @details In every step the local operator is diagonalized and the core is replaced by the eigenvectors to its smallest eigenvalues.
+		* @param _A symmetric operator
+		* @param[in,out] _x in: initial guess, out: the approximated orthonormal eigenvectors
+		* @returns the approximated eigenvalues in ascending order
+		*/
+		std::vector<value_t> lowest_eigenpairs(const TTOperator &_A, BlockTT &_x) const;
+		
+	private:
+		/// @brief Performs the sweeps, solving the local linear systems if @a _b is given and the local eigenproblems otherwise. Returns the local eigenvalues resp. energies.
+		std::vector<value_t> sweep(const TTOperator &_A, BlockTT &_x, const std::vector<TTTensor> *_b) const;
+	};
+	
+	/// default variant of the block ALS algorithm
+	extern const BlockALSVariant BlockALS;
+}
@@ -68,5 +68,13 @@ namespace xerus {
 		
 		/// @brief Internal deleter function, needed because std::shared_ptr misses an array overload.
 		void array_deleter_st(size_t* const _toDelete);
+		
+		/// @brief Internal deleter for dense storage that was allocated with more entries than currently used, see Tensor::reserve().
+		struct reserved_array_deleter_vt {
+			/// @brief The number of allocated entries.
+			size_t capacity;
+			
+			void operator()(value_t* const _toDelete) const;
+		};
 	}
 }
@@ -44,7 +44,6 @@ namespace xerus {
 		///@brief: Computes the dot product = x^T*y
 		double dot_product(const double* const _x, const size_t _n, const double* const _y);
 		
-		
 		//----------------------------------------------- LEVEL II BLAS ---------------------------------------------------------
 		
 		///@brief: Perfroms x = alpha*OP(A)*y
@@ -125,12 +124,35 @@ namespace xerus {
 		void rq_destructive( double* const _R, double* const _Q, double* const _A, const size_t _m, const size_t _n);
 
 		
-	/*  TODO we need test cases for these  
-		///@brief: Solves Ax = b for x
+		///@brief: Solves Ax = b for x. The LU factorisation is done in single precision and refined to double precision.
 		void solve( double* const _x, const double* const _A, const size_t _n, const double* const _b);
 		
-		///@brief: Solves Ax = b for x, Destroys A and b
-		void solve_destructive( double* const _bToX, double* const _A, const size_t _n);*/
+		///@brief: Solves Ax = b for x using mixed precision iterative refinement. Destroys A and b.
+		void solve_destructive( double* const _x, double* const _A, const size_t _n, double* const _b);
+		
+		///@brief: Solves Ax = b for symmetric positive definite A. The Cholesky factorisation is done in single precision and refined to double precision. Returns false if A is not positive definite, in which case x is undefined.
+		bool solve_positive_definite( double* const _x, const double* const _A, const size_t _n, const double* const _b);
+		
+		///@brief: Solves Ax = b for symmetric positive definite A using mixed precision iterative refinement. Destroys A and b. Returns false if A is not positive definite.
+		bool solve_positive_definite_destructive( double* const _x, double* const _A, const size_t _n, double* const _b);
+		
+		///@brief: Overrides the symmetric matrix A with its Cholesky factor L (A = LL^T). Returns false if A is not positive definite, in which case A is destroyed.
+		bool cholesky_destructive( double* const _A, const size_t _n);
+		
+		///@brief: Solves LL^T x = b for x, where L was computed by cholesky_destructive. For @a _nrhs > 1, x and b are n x nrhs matrices.
+		void solve_cholesky( double* const _x, const double* const _L, const size_t _n, const double* const _b, const size_t _nrhs = 1);
+		
+		///@brief: Overrides the symmetric matrix A with its Bunch-Kaufman factorisation A = LDL^T, the pivoting is stored in @a _pivot.
+		void ldl_destructive( double* const _A, int* const _pivot, const size_t _n);
+		
+		///@brief: Solves LDL^T x = b for x, where the factorisation was computed by ldl_destructive. For @a _nrhs > 1, x and b are n x nrhs matrices.
+		void solve_ldl( double* const _x, const double* const _LD, const int* const _pivot, const size_t _n, const double* const _b, const size_t _nrhs = 1);
+		
+		///@brief: Solves Ax = b for symmetric A via a Cholesky factorisation, or LDL^T if A is not positive definite. For @a _nrhs > 1, x and b are n x nrhs matrices. Returns whether A is positive definite.
+		bool solve_symmetric( double* const _x, const double* const _A, const size_t _n, const double* const _b, const size_t _nrhs = 1);
+		
+		///@brief: Computes all eigenvalues of the symmetric matrix A in ascending order. A is overwritten by the orthonormal eigenvectors, stored as its columns.
+		void symmetric_eigen_decomposition_destructive( double* const _eigenvalues, double* const _A, const size_t _n);
 		
 		
 		
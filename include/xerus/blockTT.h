@@ -0,0 +1,116 @@
+// Xerus - A General Purpose Tensor Library
+// Copyright (C) 2014-2016 Benjamin Huber and Sebastian Wolf. 
+// 
+// Xerus is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+// 
+// Xerus is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+// 
+// You should have received a copy of the GNU Affero General Public License
+// along with Xerus. If not, see <http://www.gnu.org/licenses/>.
+//
+// For further information on Xerus visit https://libXerus.org 
+// or contact us at contact@libXerus.org.
+
+
+/**
+* @file
+* @brief Header file for the BlockTT class.
+*/
+
+#pragma once
+
+#include "misc/check.h"
+#include "misc/containerSupport.h"
+
+#include "tensor.h"
+#include "ttNetwork.h"
+
+namespace xerus {
+	/**
+	* @brief Compact representation of several TTTensors of equal dimensions that share all components but the core.
+	* @details The core at position corePosition carries an additional block index, i.e. it has the dimensions (r1, n, blockSize, r2),
+	* while all other components have the usual dimensions (r1, n, r2). All components left of the core are left-orthogonal and all components right 
+	* of it are right-orthogonal, so the i-th tensor of the block is obtained by fixing the block index of the core to i, cf. get_block().
+	* When the core is moved, the block index moves along with it.
+	*/
+	class BlockTT {
+	public:
+		/// @brief The external dimensions of every tensor in the block.
+		std::vector<size_t> dimensions;
+		
+		/// @brief The number of tensors represented.
+		size_t blockSize;
+		
+		/// @brief The position of the core, i.e. of the component that carries the block index.
+		size_t corePosition;
+		
+		/// @brief The components, components[corePosition] has the dimensions (r1, n, blockSize, r2).
+		std::vector<Tensor> components;
+		
+		
+		/**
+		* @brief Creates a BlockTT of zero tensors with the given dimensions and ranks and the core at position zero.
+		* @details The components other than the core are arbitrary orthogonal.
+		*/
+		BlockTT(const std::vector<size_t>& _dimensions, const std::vector<size_t>& _ranks, const size_t _blockSize);
+		
+		/**
+		* @brief Creates a BlockTT that represents the given tensors, with the core at position zero.
+		* @details The tensors are stacked as a TTTensor with an additional last component for the block index, which is rounded and then moved to position zero.
+		* The resulting ranks are those of the stacked tensors, i.e. at most the sums of the ranks of the given tensors.
+		*/
+		explicit BlockTT(const std::vector<TTTensor>& _tensors);
+		
+		/**
+		* @brief Random constructs a BlockTT with the given dimensions and ranks and the core at position zero.
+		* @details The entries of the components are sampled independendly using the provided random generator and distribution, then the components are orthogonalized.
+		*/
+		template<class generator, class distribution>
+		static BlockTT random(const std::vector<size_t>& _dimensions, const std::vector<size_t>& _ranks, const size_t _blockSize, generator& _rnd, distribution& _dist) {
+			BlockTT result(_dimensions, _ranks, _blockSize);
+			const std::vector<size_t> targetRank = TTTensor::reduce_to_maximal_ranks(_ranks, _dimensions);
+			for(size_t i = 0; i < _dimensions.size(); ++i) {
+				const size_t leftRank = i==0 ? 1 : targetRank[i-1];
+				const size_t rightRank = i+1==_dimensions.size() ? 1 : targetRank[i];
+				if(i == 0) {
+					result.components[i] = Tensor::random({leftRank, _dimensions[i], _blockSize, rightRank}, _rnd, _dist);
+				} else {
+					result.components[i] = Tensor::random({leftRank, _dimensions[i], rightRank}, _rnd, _dist);
+				}
+			}
+			result.orthogonalize_right_part();
+			return result;
+		}
+		
+		/// @brief Returns the degree of the represented tensors.
+		size_t degree() const;
+		
+		/// @brief Returns the ranks of the BlockTT, i.e. the dimensions of the links between the components.
+		std::vector<size_t> ranks() const;
+		
+		/// @brief Returns the @a _block-th tensor represented, cannonicalized with the core at corePosition.
+		TTTensor get_block(const size_t _block) const;
+		
+		/**
+		* @brief Moves the core (and thereby the block index) to position @a _position.
+		* @details Every step is a SVD of the core that separates the old position from the new one. As the block index moves along, the ranks may increase
+		* up to blockSize times the old ranks.
+		* @param _maxRank the maximal rank of every edge that is passed.
+		* @param _eps the relative truncation threshold for the singular values of every step.
+		*/
+		void move_core(const size_t _position, const size_t _maxRank = std::numeric_limits<size_t>::max(), const double _eps = EPSILON);
+		
+		/// @brief Checks whether the dimensions of all components fit together.
+		void require_correct_format() const;
+		
+	private:
+		/// @brief Makes all components right of position zero right-orthogonal by RQ decompositions, requires the core to be at position zero.
+		void orthogonalize_right_part();
+	};
+}
@@ -0,0 +1,83 @@
+// Xerus - A General Purpose Tensor Library
+// Copyright (C) 2014-2016 Benjamin Huber and Sebastian Wolf. 
+// 
+// Xerus is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+// 
+// Xerus is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+// 
+// You should have received a copy of the GNU Affero General Public License
+// along with Xerus. If not, see <http://www.gnu.org/licenses/>.
+//
+// For further information on Xerus visit https://libXerus.org 
+// or contact us at contact@libXerus.org.
+
+/**
+ * @file
+ * @brief Header file for the CompiledContraction class.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "tensor.h"
+
+namespace xerus {
+
+	/**
+	 * @brief Contraction of two Tensors whose index mapping is resolved once and reused for every execution.
+	 * @details The contraction is given as an einsum like string with one letter per mode, e.g. "ij,jk->ik" for a matrix product.
+	 * Letters that appear in both operands but not in the result are contracted. Every other letter has to appear in exactly one operand and in the result.
+	 * The reshuffles and the call to contract() are determined by the constructor, so an execution performs no index bookkeeping at all.
+	 * Whenever possible the operands are passed to contract() as they are (possibly transposed) and the result is written directly into the output.
+	 * Otherwise the reshuffled operands and the intermediate result are kept in buffers that are reused by the next execution.
+	 * As these buffers are members, a single CompiledContraction must not be executed concurrently.
+	 */
+	class CompiledContraction {
+	public:
+		/// @brief The einsum like expression this contraction was compiled from.
+		const std::string expression;
+		
+	private:
+		/// @brief Whether the operands are swapped, i.e. the first operand of contract() is the rhs of the expression.
+		bool swapOperands;
+		
+		/// @brief Number of modes that are contracted.
+		size_t numContracted;
+		
+		/// @brief Shuffle applied to the first operand of contract(), empty if it can be used as is.
+		std::vector<size_t> firstShuffle;
+		
+		/// @brief Whether the first operand of contract() is transposed, i.e. its contracted modes are in front.
+		bool firstTrans;
+		
+		/// @brief Shuffle applied to the second operand of contract(), empty if it can be used as is.
+		std::vector<size_t> secondShuffle;
+		
+		/// @brief Whether the second operand of contract() is transposed, i.e. its contracted modes are in the back.
+		bool secondTrans;
+		
+		/// @brief Shuffle from the result of contract() to the requested result, empty if they coincide.
+		std::vector<size_t> resultShuffle;
+		
+		/// @brief Buffers for reshuffled operands and the unshuffled result.
+		Tensor firstBuffer, secondBuffer, resultBuffer;
+		
+	public:
+		/// @brief Compiles the contraction described by @a _expression, e.g. "ab,arj->brj".
+		explicit CompiledContraction(const std::string& _expression);
+		
+		/// @brief Calculates _result = _lhs * _rhs as described by the expression.
+		void operator()(Tensor& _result, const Tensor& _lhs, const Tensor& _rhs);
+		
+		/// @brief Returns _lhs * _rhs as described by the expression.
+		Tensor operator()(const Tensor& _lhs, const Tensor& _rhs);
+	};
+}
@@ -42,4 +42,5 @@
 #include "misc/sort.h"
 #include "misc/math.h"
 #include "misc/missingFunctions.h"
+#include "misc/parallel.h"
 #include "misc/fileIO.h"
@@ -0,0 +1,108 @@
+// Xerus - A General Purpose Tensor Library
+// Copyright (C) 2014-2016 Benjamin Huber and Sebastian Wolf. 
+// 
+// Xerus is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+// 
+// Xerus is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+// 
+// You should have received a copy of the GNU Affero General Public License
+// along with Xerus. If not, see <http://www.gnu.org/licenses/>.
+//
+// For further information on Xerus visit https://libXerus.org 
+// or contact us at contact@libXerus.org.
+
+/**
+ * @file
+ * @brief Header file for the parallel execution helpers used by xerus.
+ */
+
+#pragma once
+
+#include "standard.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+namespace xerus {
+	namespace misc {
+		
+		/**
+		 * @brief Sets the overall number of threads xerus may use.
+		 * @details This bounds the OpenMP team sizes of xerus (and of all later parallel regions started by the calling thread) and the number 
+		 * of threads of the BLAS library outside of parallel regions. Zero restores the defaults of OpenMP and BLAS.
+		 * Changing the BLAS threads is supported for OpenBLAS, MKL and BLIS and silently ignored otherwise.
+		 */
+		void set_thread_budget(const size_t _numThreads);
+		
+		///@brief Returns the overall number of threads xerus may use (one if xerus is compiled without OpenMP).
+		size_t get_thread_budget();
+		
+		///@brief Sets the number of threads the BLAS library may use, if supported by the linked BLAS (OpenBLAS, MKL or BLIS).
+		void set_blas_threads(const size_t _numThreads);
+		
+		///@brief Returns the number of threads the BLAS library may use (one if it cannot be determined).
+		size_t get_blas_threads();
+		
+		
+		/**
+		 * @brief Splits the thread budget between an OpenMP team and the BLAS calls made by its members for the lifetime of this object.
+		 * @details Each member of a team of @a _teamSize threads gets get_thread_budget()/_teamSize (but at least one) BLAS threads. Teams of a single
+		 * thread and splits created inside of an active parallel region (i.e. nested parallelism) leave BLAS untouched, as the enclosing split already pinned it.
+		 * The previous number of BLAS threads is restored on destruction. With PERFORMANCE_ANALYSIS the splits are recorded under "Threads".
+		 */
+		class ThreadBudgetSplit final {
+		public:
+			explicit ThreadBudgetSplit(const size_t _teamSize = get_thread_budget());
+			ThreadBudgetSplit(const ThreadBudgetSplit&) = delete;
+			ThreadBudgetSplit& operator=(const ThreadBudgetSplit&) = delete;
+			~ThreadBudgetSplit();
+			
+			///@brief The number of threads the OpenMP team should use.
+			const size_t teamSize;
+			
+		private:
+			const bool active;
+			const size_t previousBlasThreads;
+			const size_t startTime;
+		};
+		
+		
+		/**
+		 * @brief Calls @a _f(i) for all i in [0, @a _n), distributing the calls over up to get_thread_budget() threads.
+		 * @details The iterations are scheduled dynamically, as their cost typically varies (e.g. TT components of different ranks).
+		 * The BLAS threads are split via ThreadBudgetSplit. Calls from within a parallel region are executed serially by the calling thread.
+		 * Exceptions must not leave an OpenMP region, so the first exception thrown by @a _f is caught, the remaining iterations are skipped and the exception is rethrown after the loop.
+		 */
+		template<class F>
+		void parallel_for(const size_t _n, F&& _f) {
+			std::exception_ptr exception;
+			std::atomic<bool> failed(false);
+			{
+				const ThreadBudgetSplit split(std::min(_n, get_thread_budget()));
+				const int numThreads = static_cast<int>(split.teamSize);
+				#pragma omp parallel for schedule(dynamic) num_threads(std::max(numThreads, 1)) if(numThreads > 1)
+				for (size_t i = 0; i < _n; ++i) {
+					if (failed) { continue; }
+					try {
+						_f(i);
+					} catch (...) {
+						#pragma omp critical(xerus_misc_parallel_for)
+						{
+							if (!exception) { exception = std::current_exception(); }
+						}
+						failed = true;
+					}
+				}
+			}
+			if (exception) {
+				std::rethrow_exception(exception);
+			}
+		}
+	}
+}
@@ -32,6 +32,7 @@
 #include "basic.h"
 #include "misc/containerSupport.h"
 #include "misc/fileIO.h"
+#include "misc/math.h"
 
 #include "indexedTensor.h"
 
@@ -642,6 +643,8 @@ namespace xerus {
 		/** 
 		 * @brief Resizes a specific mode of the Tensor.
 		 * @details Use this function only if the content of the tensor shall stay, otherwise use reset().
+		 * If the dense data is not shared and was reserved with sufficient capacity (see reserve()), the slates are moved within the
+		 * existing storage instead of allocating a new one.
 		 * @param _mode the mode to resize.
 		 * @param _newDim the new dimension that mode shall have.
 		 * @param _cutPos the position within the selected mode in front of which slates are inserted 
@@ -656,6 +659,23 @@ namespace xerus {
 		}
 		
 		
+		/** 
+		 * @brief Reserves dense storage for at least @a _capacity entries.
+		 * @details Subsequent calls to resize_mode() that do not exceed this capacity work in place. If the storage has to be reallocated 
+		 * nevertheless, the new storage is again reserved with at least twice the current capacity. Copying the tensor data (e.g. by ensure_own_data()) 
+		 * drops the reservation. Has no effect on sparse tensors.
+		 * @param _capacity the number of entries to reserve.
+		 */
+		void reserve(const size_t _capacity);
+		
+		
+		/** 
+		 * @brief Returns the number of entries the dense storage can hold without reallocation, i.e. size unless reserve() was used.
+		 * @details Returns zero for sparse tensors.
+		 */
+		size_t capacity() const;
+		
+		
 		/** 
 		 * @brief Fixes a specific mode to a specific value, effectively reducing the order by one.
 		 * @param _mode the mode in which the slate shall be fixed, e.g. 0 to fix the first mode.
@@ -723,7 +743,42 @@ namespace xerus {
 		 * @param _f the function to call to modify each entry.
 		 */
 		void modify_elements(const std::function<void(value_t&, const MultiIndex&)>& _f);
-		
+
+
+		/**
+		 * @brief Modifies every entry according to the given function.
+		 * @details Templated variant of the std::function overload that allows the compiler to inline @a _f. Only the current entry is passed to @a _f.
+		 * @param _f the function to call to modify each entry.
+		 */
+		template<class F, decltype(std::declval<F&>()(std::declval<value_t&>()), int()) = 0>
+		void modify_elements(F&& _f) {
+			ensure_own_data_and_apply_factor();
+			if(is_dense()) {
+				value_t* const dataPtr = denseData.get();
+				for(size_t i = 0; i < size; ++i) { _f(dataPtr[i]); }
+			} else {
+				modify_sparse_elements([&](value_t& _entry, const size_t){ _f(_entry); });
+			}
+		}
+
+
+		/**
+		 * @brief Modifies every entry according to the given function.
+		 * @details Templated variant of the std::function overload that allows the compiler to inline @a _f. The current entry together
+		 * with its position, assuming row-major ordering is passed to @a _f.
+		 * @param _f the function to call to modify each entry.
+		 */
+		template<class F, decltype(std::declval<F&>()(std::declval<value_t&>(), size_t()), int()) = 0>
+		void modify_elements(F&& _f) {
+			ensure_own_data_and_apply_factor();
+			if(is_dense()) {
+				value_t* const dataPtr = denseData.get();
+				for(size_t i = 0; i < size; ++i) { _f(dataPtr[i], i); }
+			} else {
+				modify_sparse_elements(_f);
+			}
+		}
+
 		/** 
 		 * @brief Adds the given Tensor with the given offsets to this one.
 		 * @param _other Tensor that shall be added to this one, the orders must coincide.
@@ -776,6 +831,26 @@ namespace xerus {
 		/// @brief Adds the given sparse data to the given sparse data
 		static void add_sparse_to_sparse(const std::shared_ptr<std::map<size_t, value_t>>& _sum, const value_t _factor, const std::shared_ptr<const std::map<size_t, value_t>>& _summand);
 		
+		/// @brief Passes every entry (including the implicit zeros) together with its position to @a _f and keeps only the resulting non-zero entries. Requires a sparse representation and own data.
+		template<class F>
+		void modify_sparse_elements(F&& _f) {
+			std::unique_ptr<std::map<size_t, value_t>> newData(new std::map<size_t, value_t>());
+			std::map<size_t, value_t>::const_iterator entry = sparseData->cbegin();
+			for(size_t i = 0; i < size; ++i) {
+				value_t val = 0.0;
+				if(entry != sparseData->cend() && entry->first == i) {
+					val = entry->second;
+					++entry;
+				}
+				_f(val, i);
+				if(misc::hard_not_equal(val, 0.0)) {
+					newData->emplace_hint(newData->end(), i, val);
+				}
+			}
+			sparseData.reset(newData.release());
+			use_dense_representation_if_desirable();
+		}
+		
 	public:
 		
 		/// @brief Ensures that this tensor is the sole owner of its data. If needed new space is allocated and all entries are copied.
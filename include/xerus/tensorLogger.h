@@ -30,6 +30,7 @@ SET_LOGGING(ContractionDebug, xerus::misc::internal::LOGGING_ON_ERROR)
 SET_LOGGING(TNContract, xerus::misc::internal::LOGGING_ON_ERROR)
 SET_LOGGING(TensorAssignment, xerus::misc::internal::LOGGING_ON_ERROR)
 SET_LOGGING(ALS, xerus::misc::internal::LOGGING_ON_ERROR)
+SET_LOGGING(BlockALS, xerus::misc::internal::LOGGING_ON_ERROR)
 SET_LOGGING(unit_test, xerus::misc::internal::LOGGING_ON_ERROR)
 SET_LOGGING(unit_tests, xerus::misc::internal::LOGGING_ON_ERROR)
 SET_LOGGING(largestEntry, xerus::misc::internal::LOGGING_ON_ERROR)
@@ -42,6 +42,12 @@ namespace xerus {
 	*/
 	class TensorNetwork {
 	public:
+		///@brief Minimal estimated cost of a set of independent pairwise contractions to perform them in parallel in contract(). NOTE not const so that users can modify this value!
+		static double minParallelContractionCost;
+		
+		///@brief Memory budget in bytes for the node tensors during a contract(). If a contraction is expected to exceed it, links are sliced, see plan_contraction(). Zero disables slicing. NOTE not const so that users can modify this value!
+		static size_t contractionMemoryBudget;
+		
 		///@brief: Represention of the ranks of a TensorNetwork.
 		using RankTuple = std::vector<size_t>; 
 		
@@ -82,10 +88,12 @@ namespace xerus {
 		
 		/**
 		* @brief The TensorNode class is used by the class TensorNetwork to store the componentent tensors defining the network.
+		* @details Copying a node copies only the Tensor object, whose data is shared with the original (cf. Tensor::ensure_own_data()).
+		* The data is only duplicated once one of the copies modifies its entries, so copying a TensorNetwork costs O(#nodes) and not O(#entries).
 		*/
 		class TensorNode final {
 		public:
-			///@brief Save slot for the tensorObject associated with this node.
+			///@brief Save slot for the tensorObject associated with this node. Each node owns its Tensor object, the data of the Tensor may be shared between copies.
 			std::unique_ptr<Tensor> tensorObject;
 			
 			///@brief Vector of links defining the connection of this node to the network.
@@ -120,6 +128,24 @@ namespace xerus {
 			void erase() noexcept;
 		};
 		
+		
+		/**
+		 * @brief Plan for the contraction of a set of nodes, as determined by plan_contraction().
+		 */
+		struct ContractionPlan {
+			///@brief The pairwise contractions in the order they are performed. The first node of each pair holds the result.
+			std::vector<std::pair<size_t, size_t>> order;
+			
+			///@brief The sliced links, each given as (node, mode) of one of its ends. Every slice fixes all of them to a single slate.
+			std::vector<std::pair<size_t, size_t>> slicedLinks;
+			
+			///@brief The number of slices, i.e. the product of the dimensions of all sliced links.
+			size_t numSlices = 1;
+			
+			///@brief The expected peak memory in bytes of all node tensors involved while contracting a single slice.
+			size_t peakMemory = 0;
+		};
+		
 	protected:
 		
 		/** 
@@ -231,6 +257,27 @@ namespace xerus {
 		 */
 		void perform_traces(const size_t _nodeId);
 		
+		
+		/**
+		 * @brief Calculates the tensor of the contraction of @a _nodeId1 and @a _nodeId2 and stores it in @a _nodeId1, without changing any links.
+		 * @details Only the tensorObjects of the two nodes are modified, so this may be called concurrently for disjoint pairs of nodes.
+		 */
+		void contract_node_tensors(const size_t _nodeId1, const size_t _nodeId2);
+		
+		
+		/**
+		 * @brief Updates the links after contract_node_tensors(@a _nodeId1, @a _nodeId2) and erases @a _nodeId2.
+		 */
+		void relink_contracted_nodes(const size_t _nodeId1, const size_t _nodeId2);
+		
+		
+		/**
+		 * @brief Performs the sliced contraction described by @a _plan and returns the id of the resulting node.
+		 * @details Each slice works on a copy of the network (sharing the node data) in which the sliced links are fixed to a single slate.
+		 * The slices are distributed over the thread budget and their results are summed up.
+		 */
+		size_t contract_sliced(const ContractionPlan& _plan);
+		
 	public:
 		
 		/** 
@@ -537,6 +584,30 @@ namespace xerus {
 		size_t contract(const std::set<size_t>& _ids);
 		
 		
+		/**
+		 * @brief Determines how contract(@a _ids) would contract the given nodes, including the expected peak memory.
+		 * @details The order of pairwise contractions is chosen by the contraction heuristics. If the expected peak memory exceeds
+		 * @a _memoryBudget, internal links between the nodes are sliced greedily (always choosing the link that reduces the peak the most)
+		 * until the budget is met or no link reduces it any further. Every slice is then contracted independently and the results are summed up.
+		 * Note that slices contracted in parallel need the peak memory each.
+		 * @param _ids set with all ids to be contracted.
+		 * @param _memoryBudget the memory budget in bytes, zero to never slice.
+		 * @return the plan.
+		 */
+		ContractionPlan plan_contraction(const std::set<size_t>& _ids, const size_t _memoryBudget = contractionMemoryBudget) const;
+		
+		
+		/**
+		 * @brief Calculates the environments of all nodes of a TensorNetwork of degree zero, i.e. for each node the contraction of all other nodes.
+		 * @details The environment of a node has the dimensions of the node itself, such that contracting the node with its environment yields the value
+		 * of the network. In other words the environment is the derivative of the network with respect to that node. All environments are obtained from
+		 * the contraction tree chosen by the heuristics in one forward and one backward pass, which reuses the intermediate results and needs three 
+		 * contractions per node instead of a separate contraction of the remaining network for every node. Nodes must not have traces.
+		 * @return the environments indexed by node id, erased nodes get an empty Tensor.
+		 */
+		std::vector<Tensor> environments() const;
+		
+		
 		/** 
 		* @brief Calculates the frobenious norm of the TensorNetwork.
 		* @return the frobenious norm of the TensorNetwork.
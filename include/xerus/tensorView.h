@@ -0,0 +1,90 @@
+// Xerus - A General Purpose Tensor Library
+// Copyright (C) 2014-2016 Benjamin Huber and Sebastian Wolf. 
+// 
+// Xerus is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+// 
+// Xerus is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+// 
+// You should have received a copy of the GNU Affero General Public License
+// along with Xerus. If not, see <http://www.gnu.org/licenses/>.
+//
+// For further information on Xerus visit https://libXerus.org 
+// or contact us at contact@libXerus.org.
+
+/**
+ * @file
+ * @brief Header file for the TensorView class.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "basic.h"
+
+namespace xerus {
+	class Tensor;
+	
+	/**
+	 * @brief Non-owning, strided view of the entries of a dense Tensor.
+	 * @details A TensorView consists of a pointer to its first entry and a stride for every mode. Fixing or restricting modes only adjusts
+	 * the pointer and the strides, so slicing a TT component or any other dense tensor is O(degree) regardless of the number of entries.
+	 * Views that are (possibly transposed) matrices with a leading dimension are passed to BLAS directly by contract(), all others are copied first.
+	 * The view does not keep the data alive, i.e. it must not outlive the viewed Tensor and becomes invalid if the Tensor is modified.
+	 */
+	class TensorView {
+	public:
+		/// @brief Pointer to the entry at position zero of the view.
+		const value_t* data;
+		
+		/// @brief Dimensions of the view.
+		std::vector<size_t> dimensions;
+		
+		/// @brief Distance (in entries) between two consecutive slates of each mode.
+		std::vector<size_t> strides;
+		
+		/// @brief Global factor of the view, inherited from the viewed Tensor.
+		value_t factor;
+		
+		/// @brief Creates a view of all entries of the dense Tensor @a _tensor.
+		explicit TensorView(const Tensor& _tensor);
+		
+		/// @brief Returns the degree of the view.
+		size_t degree() const;
+		
+		/// @brief Returns the number of entries of the view.
+		size_t size() const;
+		
+		/// @brief Returns whether the entries of the view are stored contiguously in row-major order.
+		bool is_contiguous() const;
+		
+		/// @brief Returns the entry at the given position (including the factor).
+		value_t operator[](const std::vector<size_t>& _positions) const;
+		
+		/// @brief Restricts the view to the slate @a _slatePosition of the mode @a _mode, removing this mode. O(degree).
+		void fix_mode(const size_t _mode, const size_t _slatePosition);
+		
+		/// @brief Restricts the mode @a _mode to the slates [_first, _first+_newDim). O(1).
+		void restrict_mode(const size_t _mode, const size_t _first, const size_t _newDim);
+		
+		/// @brief Copies the viewed entries into a new dense Tensor.
+		explicit operator Tensor() const;
+	};
+	
+	
+	/**
+	 * @brief Low-level contraction of two TensorViews, cf. the corresponding contract() for Tensors.
+	 * @details Views that are strided matrices w.r.t. the split into contracted and remaining modes are multiplied in place, all others are copied first.
+	 * The result is always dense.
+	 */
+	void contract(Tensor& _result, const TensorView& _lhs, const bool _lhsTrans, const TensorView& _rhs, const bool _rhsTrans, const size_t _numModes);
+	
+	/// @brief Copies the entries of @a _base into the dense Tensor @a _out, moving every mode i to position _shuffle[i], cf. the corresponding reshuffle() for Tensors.
+	void reshuffle(Tensor& _out, const TensorView& _base, const std::vector<size_t>& _shuffle);
+}
@@ -393,6 +393,24 @@ namespace xerus {
 		size_t rank(const size_t _i) const;
 		
 		
+		/** 
+		* @brief Reserves storage in all components such that the ranks can grow up to @a _maxRanks without reallocation.
+		* @details See Tensor::reserve(). Ranks that are already larger than the given ones are not affected.
+		* @param _maxRanks the ranks to reserve storage for.
+		*/
+		void reserve_ranks(const std::vector<size_t>& _maxRanks);
+		
+		
+		/** 
+		* @brief Increases the ranks to @a _newRanks by appending zero slates to the rank modes of the components.
+		* @details The represented tensor does not change. The components are resized via Tensor::resize_mode(), i.e. in place if 
+		* enough storage was reserved with reserve_ranks(). As the enlarged components are no longer orthogonal, the TTNetwork
+		* is not cannonicalized afterwards if any rank changed.
+		* @param _newRanks the new ranks, each has to be at least the current one.
+		*/
+		void grow_ranks(const std::vector<size_t>& _newRanks);
+		
+		
 		/** 
 		* @brief Move the core to a new position.
 		* @details The core is moved to @a _position and the nodes between the old and the new position are orthogonalized
@@ -428,7 +446,8 @@ namespace xerus {
 		
 		/** 
 		* @brief Transpose the TTOperator
-		* @details Swaps all external indices to create the transposed operator.
+		* @details Swaps all external indices to create the transposed operator. Within indexed expressions, e.g. A(j/2, i/2)*x(j&0), the transposition
+		* is only a relabeling of the links that the contraction resolves for free, so this is only required to store A^T itself in TT format.
 		*/
 		template<bool B = isOperator, typename std::enable_if<B, int>::type = 0>
 		void transpose() {
@@ -448,6 +467,14 @@ namespace xerus {
 		virtual value_t frob_norm() const override;
 		
 		
+		/**
+		* @brief Evaluates the TTNetwork at the given positions.
+		* @details Contracts the slices of the components directly via TensorViews, reusing the partial products of common prefixes.
+		* Falls back to TensorNetwork::measure() if a component is sparse.
+		*/
+		virtual void measure(SinglePointMeasurementSet& _measurments) const override;
+		
+		
 		/** 
 		* @brief Finds the position of the approximately largest entry.
 		* @details Uses an algorithms to find an entry that is at least of size @a _accuracy * X_max in absolute value,
@@ -461,6 +488,19 @@ namespace xerus {
 		size_t find_largest_entry(const double _accuracy, const value_t _lowerBound = 0.0) const;
 		
 		
+		/**
+		* @brief Finds the @a _k entries of largest absolute value by a beam search over the components.
+		* @details The components are traversed from left to right, keeping the @a _beamWidth partial positions whose slices of the tensor have the 
+		* largest norms. As all components but the first are right-orthogonal after cannonicalization, these norms are simply the norms of the 
+		* left interfaces, so the search costs O(d*n*_beamWidth*r^2) and no rounding at all. In contrast to find_largest_entry() there is no guarantee
+		* on the result, but with a beam width well above the number of competing entries the largest entries are found in practice.
+		* @param _k the number of entries to find.
+		* @param _beamWidth the number of partial positions kept after each component, at least @a _k are kept.
+		* @return the positions and values of the entries found, ordered by decreasing absolute value.
+		*/
+		std::vector<std::pair<size_t, value_t>> find_largest_entries(const size_t _k, const size_t _beamWidth = 64) const;
+		
+		
 		/** 
 		 * @brief Tests whether the network resembles that of a TTTensor and checks consistency with the underlying tensor objects.
 		 * @details Note that this will NOT check for orthogonality of cannonicalized TTNetworks.
@@ -586,6 +626,63 @@ namespace xerus {
 	template<bool isOperator>
 	TTNetwork<isOperator> entrywise_product(const TTNetwork<isOperator>& _A, const TTNetwork<isOperator>& _B);
 	
+	
+	/**
+	* @brief Calculates the rounded componentwise product of two tensors given in the TT format.
+	* @details The product is formed and truncated component by component from left to right as in apply_and_round(), so the product ranks 
+	* rank(A)*rank(B) only appear within a single local tensor instead of in the whole intermediate network. The result is then rounded to 
+	* @a _maxRanks and @a _eps by a usual right-to-left sweep. If neither the ranks nor @a _eps truncate, the product is formed and rounded instead.
+	* @param _maxRanks the maximal ranks of the result.
+	* @param _eps the relative truncation threshold for the singular values, cf. TTNetwork::round().
+	*/
+	template<bool isOperator>
+	TTNetwork<isOperator> entrywise_product_and_round(TTNetwork<isOperator> _A, TTNetwork<isOperator> _B, const std::vector<size_t>& _maxRanks, const double _eps = EPSILON);
+	
+	
+	/**
+	* @brief Calculates the rounded componentwise product of two tensors given in the TT format, cf. entrywise_product_and_round() with a rank for every edge.
+	*/
+	template<bool isOperator>
+	TTNetwork<isOperator> entrywise_product_and_round(TTNetwork<isOperator> _A, TTNetwork<isOperator> _B, const size_t _maxRank, const double _eps = EPSILON);
+	
+	
+	/**
+	* @brief Calculates the rounded application A(i/2, j/2)*x(j&0) of a TTOperator to a TTTensor.
+	* @details The product is formed component by component from left to right and each new component is truncated by an SVD before the next one 
+	* is formed (zip-up), so the product ranks rank(A)*rank(x) only ever appear within a single local tensor. The zip-up truncation allows twice the 
+	* requested ranks and a tenth of @a _eps, the result is then rounded to @a _maxRanks and @a _eps by a usual right-to-left sweep.
+	* Compared to forming the product and rounding it afterwards this saves a factor of about rank(A)*rank(x)/r in time, where r are the ranks of the result.
+	* If the requested ranks are not below half the product ranks, the product is formed and rounded instead.
+	* @param _maxRanks the maximal ranks of the result.
+	* @param _eps the relative truncation threshold for the singular values, cf. TTNetwork::round().
+	*/
+	TTTensor apply_and_round(const TTOperator& _A, TTTensor _x, const std::vector<size_t>& _maxRanks, const double _eps = EPSILON);
+	
+	
+	/**
+	* @brief Calculates the rounded application A(i/2, j/2)*x(j&0) of a TTOperator to a TTTensor, cf. apply_and_round() with a rank for every edge.
+	*/
+	TTTensor apply_and_round(const TTOperator& _A, TTTensor _x, const size_t _maxRank, const double _eps = EPSILON);
+	
+	
+	/**
+	* @brief Calculates the scalar product of two tensors given in the TT format.
+	* @details The components are contracted directly from left to right, avoiding the planning and bookkeeping of a general TensorNetwork contraction.
+	* The cost is O(d*n*r^3) for ranks r of both tensors.
+	*/
+	template<bool isOperator>
+	value_t dot(const TTNetwork<isOperator>& _A, const TTNetwork<isOperator>& _B);
+	
+	
+	/**
+	* @brief Calculates the matrix of all pairwise scalar products of the given tensors in the TT format.
+	* @details Each tensor sweeps once over its components. The left interfaces with all tensors following it are stacked, so that the contraction 
+	* with its own components is a single GEMM per site. Only the upper triangle is computed, the rows are computed in parallel.
+	* @return the symmetric m x m matrix G with G[i,j] = dot(_tensors[i], _tensors[j]).
+	*/
+	template<bool isOperator>
+	Tensor gram_matrix(const std::vector<TTNetwork<isOperator>>& _tensors);
+	
 	namespace misc {
 		
 		/**
@@ -141,3 +141,83 @@ static misc::UnitTest als_tut("ALS", "tutorial", [](){
 // 	TEST(!misc::approx_equal(frob_norm(A(i^d, j^d)*X(j&0) - B(i&0)), 0., 1.));
 // 	std::cout << perfdata << std::endl;
 });
+
+static misc::UnitTest als_spd_local("ALS", "SPD_local_solver", [](){
+	std::mt19937_64 rnd(0xC0CAC01A);
+	std::normal_distribution<double> dist (0.0, 1.0);
+	Index i,j,k;
+	
+	const size_t d = 6;
+	const std::vector<size_t> stateDims(d, 3);
+	const std::vector<size_t> operatorDims(2*d, 3);
+	
+	TTOperator A = TTOperator::random(operatorDims, 2, rnd, dist);
+	A(i^d, j^d) = A(i^d, k^d) * A(j^d, k^d);
+	A += TTOperator::identity(operatorDims);
+	
+	TTTensor B = TTTensor::random(stateDims, 2, rnd, dist);
+	TTTensor C;
+	C(i&0) = A(i/2, j/2) * B(j&0);
+	
+	TTTensor X = TTTensor::random(stateDims, 4, rnd, dist);
+	ALS_SPD(A, X, C, 1e-12);
+	MTEST(frob_norm(A(i/2, j/2)*X(j&0) - C(i&0)) < 1e-6*frob_norm(C), frob_norm(A(i/2, j/2)*X(j&0) - C(i&0)));
+	
+	// Symmetric but indefinite operators are handled by the LDL^T fallback
+	const TTOperator negId = -1.0*TTOperator::identity(operatorDims);
+	X = TTTensor::random(stateDims, 2, rnd, dist);
+	ALS_SPD(negId, X, B, 1e-12);
+	MTEST(frob_norm(X+B) < 1e-10*frob_norm(B), frob_norm(X+B));
+});
+
+static misc::UnitTest als_nonsym("ALS", "non_symmetric", [](){
+	std::mt19937_64 rnd(0x7A45);
+	std::normal_distribution<double> dist (0.0, 1.0);
+	Index i,j;
+	
+	const size_t d = 5;
+	const std::vector<size_t> stateDims(d, 3);
+	const std::vector<size_t> operatorDims(2*d, 3);
+	
+	// A non-symmetric operator, i.e. the local problems are solved via the stacks of A^T A
+	TTOperator A = TTOperator::random(operatorDims, 1, rnd, dist);
+	A = TTOperator::identity(operatorDims) + (0.2/frob_norm(A))*A;
+	
+	TTTensor B = TTTensor::random(stateDims, 2, rnd, dist);
+	TTTensor C;
+	C(i&0) = A(i/2, j/2) * B(j&0);
+	
+	TTTensor X = TTTensor::random(stateDims, 4, rnd, dist);
+	xerus::ALS(A, X, C, 1e-12);
+	MTEST(frob_norm(A(i/2, j/2)*X(j&0) - C(i&0)) < 1e-6*frob_norm(C), frob_norm(A(i/2, j/2)*X(j&0) - C(i&0)));
+});
+
+static misc::UnitTest als_mixed("ALS", "mixed_precision", [](){
+	std::mt19937_64 rnd(0x5EED);
+	std::normal_distribution<double> dist (0.0, 1.0);
+	Index i,j,k;
+	
+	const size_t d = 6;
+	const std::vector<size_t> stateDims(d, 3);
+	const std::vector<size_t> operatorDims(2*d, 3);
+	
+	TTOperator A = TTOperator::random(operatorDims, 2, rnd, dist);
+	A(i^d, j^d) = A(i^d, k^d) * A(j^d, k^d);
+	A += TTOperator::identity(operatorDims);
+	
+	TTTensor B = TTTensor::random(stateDims, 2, rnd, dist);
+	TTTensor C;
+	C(i&0) = A(i/2, j/2) * B(j&0);
+	
+	ALSVariant mixedSPD = ALS_SPD;
+	mixedSPD.useMixedPrecision = true;
+	TTTensor X = TTTensor::random(stateDims, 4, rnd, dist);
+	mixedSPD(A, X, C, 1e-12);
+	MTEST(frob_norm(A(i/2, j/2)*X(j&0) - C(i&0)) < 1e-5*frob_norm(C), frob_norm(A(i/2, j/2)*X(j&0) - C(i&0))/frob_norm(C));
+	
+	ALSVariant mixedALS = xerus::ALS;
+	mixedALS.useMixedPrecision = true;
+	X = TTTensor::random(stateDims, 4, rnd, dist);
+	mixedALS(A, X, C, 1e-12);
+	MTEST(frob_norm(A(i/2, j/2)*X(j&0) - C(i&0)) < 1e-5*frob_norm(C), frob_norm(A(i/2, j/2)*X(j&0) - C(i&0))/frob_norm(C));
+});
@@ -0,0 +1,165 @@
+// Xerus - A General Purpose Tensor Library
+// Copyright (C) 2014-2016 Benjamin Huber and Sebastian Wolf. 
+// 
+// Xerus is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+// 
+// Xerus is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+// 
+// You should have received a copy of the GNU Affero General Public License
+// along with Xerus. If not, see <http://www.gnu.org/licenses/>.
+//
+// For further information on Xerus visit https://libXerus.org 
+// or contact us at contact@libXerus.org.
+
+
+
+#include<xerus.h>
+
+#include "../../include/xerus/misc/test.h"
+using namespace xerus;
+
+static misc::UnitTest blocktt_format("BlockTT", "format", [](){
+	std::mt19937_64 rnd(0xB10C);
+	std::normal_distribution<value_t> dist (0.0, 1.0);
+	
+	const std::vector<size_t> dims({3, 4, 2, 3});
+	std::vector<TTTensor> tensors;
+	for (size_t k = 0; k < 3; ++k) {
+		tensors.push_back(TTTensor::random(dims, {2, 3, 2}, rnd, dist));
+	}
+	
+	BlockTT X(tensors);
+	X.require_correct_format();
+	TEST(X.blockSize == 3 && X.corePosition == 0);
+	for (size_t pos : {3ul, 1ul, 2ul, 0ul}) {
+		X.move_core(pos);
+		X.require_correct_format();
+		TEST(X.corePosition == pos);
+		for (size_t k = 0; k < 3; ++k) {
+			MTEST(frob_norm(X.get_block(k) - tensors[k]) < 1e-12*frob_norm(tensors[k]), pos << " " << k << ": " << frob_norm(X.get_block(k) - tensors[k]));
+		}
+	}
+	
+	// The blocks of a random BlockTT share the orthogonal components, so they are as orthogonal as their cores
+	BlockTT Y = BlockTT::random(dims, {2, 3, 2}, 2, rnd, dist);
+	Y.require_correct_format();
+	TEST(Y.ranks() == std::vector<size_t>({2, 3, 2}));
+	const Tensor G = gram_matrix(std::vector<TTTensor>({Y.get_block(0), Y.get_block(1)}));
+	Tensor core(Y.components[0]);
+	core.reinterpret_dimensions({3, 2, 2});
+	const Index i, j, k, l;
+	Tensor coreGram;
+	coreGram(j, l) = core(i, j, k) * core(i, l, k);
+	TEST(approx_equal(G, coreGram, 1e-12));
+});
+
+
+static misc::UnitTest blockals_solve("BlockALS", "multiple_rhs", [](){
+	std::mt19937_64 rnd(0xB5);
+	std::normal_distribution<value_t> dist (0.0, 1.0);
+	const Index i, j, k;
+	
+	// A symmetric positive definite operator in full rank
+	const std::vector<size_t> dims({3, 3, 3, 3});
+	const Tensor M = Tensor::random({81, 81}, rnd, dist);
+	Tensor A;
+	A(i, k) = M(i, j) * M(k, j);
+	A += 20.0*Tensor::identity({81, 81});
+	A.reinterpret_dimensions({3, 3, 3, 3, 3, 3, 3, 3});
+	const TTOperator ttA(A);
+	
+	std::vector<TTTensor> B;
+	for (size_t rhs = 0; rhs < 4; ++rhs) {
+		B.push_back(TTTensor::random(dims, {2, 2, 2}, rnd, dist));
+	}
+	
+	// With full ranks the solutions are represented exactly
+	BlockTT X = BlockTT::random(dims, {3, 9, 3}, 4, rnd, dist);
+	const std::vector<value_t> residuals = BlockALS.solve(ttA, X, B);
+	TEST(residuals.size() == 4);
+	for (size_t rhs = 0; rhs < 4; ++rhs) {
+		MTEST(residuals[rhs] < 1e-10, rhs << ": " << residuals[rhs]);
+		Tensor x;
+		x(j&0) = Tensor(B[rhs])(i&0) / A(i/2, j/2);
+		MTEST(frob_norm(Tensor(X.get_block(rhs)) - x) < 1e-10*frob_norm(x), frob_norm(Tensor(X.get_block(rhs)) - x));
+	}
+});
+
+
+
+static misc::UnitTest blockals_truncated("BlockALS", "rank_adaptation", [](){
+	std::mt19937_64 rnd(0xADA);
+	std::normal_distribution<value_t> dist (0.0, 1.0);
+	const Index i, j, k;
+	
+	const size_t d = 5;
+	const std::vector<size_t> dims(d, 3);
+	const std::vector<size_t> operatorDims(2*d, 3);
+	TTOperator A = TTOperator::random(operatorDims, 2, rnd, dist);
+	A(i^d, j^d) = A(i^d, k^d) * A(j^d, k^d);
+	A = TTOperator::identity(operatorDims) + (1.0/frob_norm(A))*A;
+	
+	// The solutions are the blocks of a BlockTT of rank 3, so moving the block index needs ranks of at most 3*3
+	const BlockTT solution = BlockTT::random(dims, std::vector<size_t>(d-1, 3), 3, rnd, dist);
+	std::vector<TTTensor> B;
+	for (size_t rhs = 0; rhs < 3; ++rhs) {
+		B.emplace_back();
+		B.back()(i&0) = A(i/2, j/2) * solution.get_block(rhs)(j&0);
+	}
+	
+	// Starting from rank one, the ranks have to grow by the SVDs in BlockTT::move_core
+	BlockALSVariant adaptiveALS(20, 1e-12, 9);
+	BlockTT X = BlockTT::random(dims, std::vector<size_t>(d-1, 1), 3, rnd, dist);
+	std::vector<value_t> residuals = adaptiveALS.solve(A, X, B);
+	MTEST(misc::max(X.ranks()) > 1 && misc::max(X.ranks()) <= 9, X.ranks());
+	for (size_t rhs = 0; rhs < 3; ++rhs) {
+		MTEST(residuals[rhs] < 1e-8, rhs << ": " << residuals[rhs]);
+	}
+	
+	// A smaller maximal rank truncates the iterate, the solutions can then only be approximated
+	BlockALSVariant truncatedALS(6, 1e-12, 2);
+	X = BlockTT::random(dims, std::vector<size_t>(d-1, 1), 3, rnd, dist);
+	residuals = truncatedALS.solve(A, X, B);
+	MTEST(misc::max(X.ranks()) == 2, X.ranks());
+	for (size_t rhs = 0; rhs < 3; ++rhs) {
+		MTEST(residuals[rhs] > 1e-8 && residuals[rhs] < 1.0, rhs << ": " << residuals[rhs]);
+	}
+});
+
+static misc::UnitTest blockals_eigen("BlockALS", "lowest_eigenpairs", [](){
+	std::mt19937_64 rnd(0xE16);
+	std::normal_distribution<value_t> dist (0.0, 1.0);
+	const Index i, j, k;
+	
+	const std::vector<size_t> dims({3, 3, 3, 3});
+	const Tensor M = Tensor::random({81, 81}, rnd, dist);
+	Tensor A;
+	A(i, k) = M(i, j) * M(k, j);
+	A -= 30.0*Tensor::identity({81, 81});
+	
+	std::vector<value_t> eigenvalues(81);
+	Tensor eigenvectors(A);
+	blasWrapper::symmetric_eigen_decomposition_destructive(eigenvalues.data(), eigenvectors.get_dense_data(), 81);
+	
+	A.reinterpret_dimensions({3, 3, 3, 3, 3, 3, 3, 3});
+	const TTOperator ttA(A);
+	BlockTT X = BlockTT::random(dims, {3, 9, 3}, 3, rnd, dist);
+	const std::vector<value_t> values = BlockALS.lowest_eigenpairs(ttA, X);
+	
+	TEST(values.size() == 3);
+	std::vector<TTTensor> vectors;
+	for (size_t e = 0; e < 3; ++e) {
+		MTEST(misc::approx_equal(values[e], eigenvalues[e], 1e-10*std::abs(eigenvalues[e])), e << ": " << values[e] << " vs " << eigenvalues[e]);
+		vectors.push_back(X.get_block(e));
+		TTTensor residual;
+		residual(i&0) = ttA(i/2, j/2) * vectors.back()(j&0) - values[e]*vectors.back()(i&0);
+		MTEST(frob_norm(residual) < 1e-8, e << ": " << frob_norm(residual));
+	}
+	TEST(approx_equal(gram_matrix(vectors), Tensor::identity({3, 3}), 1e-12));
+});
@@ -111,6 +111,43 @@ static misc::UnitTest tensor_svd_rnd512("Tensor", "SVD_Random_512x512", [](){
 	MTEST(frob_norm(res3(l,n,m,o)*res3(l,n,m,p) - Tensor::identity(res2.dimensions)(o, p)) < 1e-12, " Vt not orthogonal");
 });
 
+static misc::UnitTest tensor_svd_block("Tensor", "SVD_block_structure", [](){
+	std::mt19937_64 rnd(0x5EED);
+	std::normal_distribution<double> dist(0.0, 1.0);
+	Index i, j, k, l, m, n;
+	
+	// Entries are only non-zero if the "charges" of the row and column indices agree, i.e. (i+j)%3 == (k+l)%3
+	Tensor A({4,5,6,3}, [&](const std::vector<size_t>& _idx){ return (_idx[0]+_idx[1])%3 == (_idx[2]+_idx[3])%3 ? dist(rnd) : 0.0; });
+	A *= -2.0;
+	Tensor B = A;
+	B.use_sparse_representation();
+	
+	for(Tensor* input : {&A, &B}) {
+		Tensor U, S, Vt, res;
+		(U(i,j,m), S(m,n), Vt(n,k,l)) = SVD((*input)(i,j,k,l));
+		res(i,j,k,l) = U(i,j,m) * S(m,n) * Vt(n,k,l);
+		MTEST(frob_norm(res - A) < 1e-13*frob_norm(A), frob_norm(res - A)/frob_norm(A));
+		
+		Tensor UtU, VVt;
+		UtU(m,n) = U(i,j,m) * U(i,j,n);
+		VVt(m,n) = Vt(m,k,l) * Vt(n,k,l);
+		MTEST(frob_norm(UtU - Tensor::identity(UtU.dimensions)) < 1e-13, frob_norm(UtU - Tensor::identity(UtU.dimensions)));
+		MTEST(frob_norm(VVt - Tensor::identity(VVt.dimensions)) < 1e-13, frob_norm(VVt - Tensor::identity(VVt.dimensions)));
+		
+		for(size_t x = 1; x < S.dimensions[0]; ++x) {
+			TEST(S[{x-1, x-1}] >= S[{x, x}]);
+		}
+		
+		// Truncation has to select the globally largest singular values
+		Tensor Ut, St, Vtt;
+		(Ut(i,j,m), St(m,n), Vtt(n,k,l)) = SVD((*input)(i,j,k,l), size_t(5));
+		TEST(St.dimensions[0] == 5);
+		for(size_t x = 0; x < 5; ++x) {
+			TEST(misc::approx_equal(St[{x, x}], S[{x, x}], 1e-13));
+		}
+	}
+});
+
 static misc::UnitTest tensor_svd_soft("Tensor", "SVD_soft_thresholding", [](){
     std::mt19937_64 rnd;
     std::normal_distribution<value_t> dist (0.0, 10.0);
@@ -290,6 +327,40 @@ static misc::UnitTest tensor_qc("Tensor", "QC", [](){
 	MTEST(frob_norm(Q(i,l,j,k,m)*Q(i,q,j,k,m) - Tensor::identity({Q.dimensions[1], Q.dimensions[1]})(l, q)) < 1e-12, " Q not orthogonal");
 });
 
+static misc::UnitTest tensor_qr_tall("Tensor", "QR_tall_skinny", [](){
+	std::mt19937_64 rnd(0x7A11);
+	std::normal_distribution<value_t> dist (0.0, 1.0);
+	
+	Tensor A = Tensor::random({40,50,6}, rnd, dist);
+	Tensor Q, R, C, res;
+	Index i, j, k, l, m;
+	
+	(Q(i,j,l), R(l,k)) = QR(A(i,j,k));
+	res(i,j,k) = Q(i,j,l)*R(l,k);
+	TEST(approx_equal(res, A, 1e-13));
+	MTEST(frob_norm(Q(i,j,l)*Q(i,j,m) - Tensor::identity({6,6})(l, m)) < 1e-12, " Q not orthogonal");
+	
+	(Q(i,j,l), C(l,k)) = QC(A(i,j,k));
+	TEST(Q.dimensions[2] == 6);
+	res(i,j,k) = Q(i,j,l)*C(l,k);
+	TEST(approx_equal(res, A, 1e-13));
+	MTEST(frob_norm(Q(i,j,l)*Q(i,j,m) - Tensor::identity({6,6})(l, m)) < 1e-12, " Q not orthogonal");
+	
+	(C(k,l), Q(l,i,j)) = CQ(A(i,j,k));
+	res(i,j,k) = C(k,l)*Q(l,i,j);
+	TEST(approx_equal(res, A, 1e-13));
+	MTEST(frob_norm(Q(l,i,j)*Q(m,i,j) - Tensor::identity({6,6})(l, m)) < 1e-12, " Q not orthogonal");
+	
+	// A rank deficient matrix has to fall back to the rank revealing factorisation
+	Tensor D({2000,6});
+	D.offset_add(Tensor::random({2000,2}, rnd, dist), {0,0});
+	(Q(i,l), C(l,k)) = QC(D(i,k));
+	MTEST(Q.dimensions[1] == 2, Q.dimensions[1]);
+	res(i,k) = Q(i,l)*C(l,k);
+	TEST(approx_equal(res, D, 1e-12));
+});
+
+
 static misc::UnitTest tensor_sqr("Tensor", "Sparse_QR", [](){
     std::mt19937_64 rnd;
     std::normal_distribution<value_t> dist (0.0, 1.0);
@@ -415,3 +415,100 @@ static misc::UnitTest tensor_prod1000("Tensor", "Product_1000x1000", [](){
     res(i,K) = A(J,i) * B(K,J);
     TEST(memcmp(res.get_dense_data(), C.get_dense_data(), sizeof(value_t)*1000*1000)==0);
 });
+
+static misc::UnitTest tensor_compiled_contraction("Tensor", "compiled_contraction", [](){
+	std::mt19937_64 rnd(0x5EED);
+	std::normal_distribution<double> dist(0.0, 1.0);
+	Index a, b, c, d, e;
+	
+	Tensor A = Tensor::random({3,4,5}, rnd, dist);
+	Tensor B = Tensor::random({5,4,6}, rnd, dist);
+	Tensor C = Tensor::random({6,3}, rnd, dist);
+	Tensor expected, res;
+	
+	// Operands used as they are
+	CompiledContraction plain("abc,cbd->ad");
+	expected(a,d) = A(a,b,c) * B(c,b,d);
+	plain(res, A, B);
+	TEST(approx_equal(res, expected, 1e-14));
+	
+	// Transposed operands
+	CompiledContraction trans("abc,da->bcd");
+	expected(b,c,d) = A(a,b,c) * C(d,a);
+	TEST(approx_equal(trans(A, C), expected, 1e-14));
+	
+	// Swapped operands
+	CompiledContraction swapped("abc,da->dbc");
+	expected(d,b,c) = A(a,b,c) * C(d,a);
+	TEST(approx_equal(swapped(A, C), expected, 1e-14));
+	
+	// Reshuffled operands and an interleaved result, repeated executions reuse the buffers
+	CompiledContraction shuffled("bac,edb->daec");
+	for(size_t k = 0; k < 3; ++k) {
+		Tensor D = Tensor::random({2,7,3}, rnd, dist);
+		Tensor E = Tensor::random({4,6,2}, rnd, dist);
+		shuffled(res, D, E);
+		expected(d,a,e,c) = D(b,a,c) * E(e,d,b);
+		TEST(approx_equal(res, expected, 1e-14));
+	}
+	
+	// Sparse operands and the result as one of the operands
+	Tensor S = Tensor::random({5,5}, 7, rnd, dist);
+	Tensor G = Tensor::random({5,5}, rnd, dist);
+	CompiledContraction matmul("ab,bc->ac");
+	expected(a,c) = S(a,b) * G(b,c);
+	matmul(G, S, G);
+	TEST(approx_equal(G, expected, 1e-14));
+});
+
+
+static misc::UnitTest tensor_structured_product("Tensor", "structured_product", [](){
+	std::mt19937_64 rnd(0x57C);
+	std::normal_distribution<value_t> dist(0.0, 1.0);
+	Index i, j, k, l, m, n;
+	Tensor res, expected;
+	
+	const Tensor T = Tensor::random({6,8,10,8}, rnd, dist);
+	
+	// Identity: relabeling of modes
+	const Tensor I = Tensor::identity({8,10,8,10});
+	res(i,m,n,l) = T(i,j,k,l) * I(j,k,m,n);
+	expected(i,m,n,l) = T(i,j,k,l) * I.dense_copy()(j,k,m,n);
+	TEST(approx_equal(res, expected, 1e-14));
+	expected(i,m,n,l) = T(i,m,n,l);
+	TEST(approx_equal(res, expected, 1e-14));
+	
+	// Kronecker: diagonal extraction with a broadcast and a scaled trace
+	const Tensor K = Tensor::kronecker({8,10,12});
+	res(i,l,m) = T(i,j,k,l) * K(j,k,m);
+	expected(i,l,m) = T(i,j,k,l) * K.dense_copy()(j,k,m);
+	TEST(approx_equal(res, expected, 1e-14));
+	
+	const Tensor K2 = 2.5*Tensor::kronecker({8,8,9});
+	res(k,i,m) = K2(j,l,m) * T(i,j,k,l);
+	expected(k,i,m) = K2.dense_copy()(j,l,m) * T(i,j,k,l);
+	TEST(approx_equal(res, expected, 1e-14));
+	
+	// Dirac: slicing
+	const Tensor D = Tensor::dirac({8,10,12}, {1,2,3});
+	res(i,m,l) = T(i,j,k,l) * D(j,k,m);
+	expected(i,m,l) = T(i,j,k,l) * D.dense_copy()(j,k,m);
+	TEST(approx_equal(res, expected, 1e-14));
+	
+	// Ones: summation with a broadcast, as lhs and rhs
+	const Tensor O = Tensor::ones({10,13});
+	res(i,j,l,m) = T(i,j,k,l) * O(k,m);
+	expected(i,j,l,m) = T(i,j,k,l) * O.sparse_copy()(k,m);
+	TEST(approx_equal(res, expected, 1e-14));
+	
+	const Tensor O2 = -3.0*Tensor::ones({6,8,12});
+	res(m,j,k) = O2(i,l,m) * T(i,j,k,l);
+	expected(m,j,k) = O2.sparse_copy()(i,l,m) * T(i,j,k,l);
+	TEST(approx_equal(res, expected, 1e-14));
+	
+	// Summation over several modes
+	const Tensor F = Tensor::ones({8,10,8,40});
+	res(i,m) = T(i,j,k,l) * F(j,k,l,m);
+	expected(i,m) = T(i,j,k,l) * F.sparse_copy()(j,k,l,m);
+	TEST(approx_equal(res, expected, 1e-13));
+});
@@ -144,3 +144,78 @@ static misc::UnitTest tensor_solve_trans("Tensor", "solve_transposed", [](){
 	MTEST(frob_norm(x3-x4) < 1e-14, "d " << frob_norm(x3-x4));
 	MTEST(frob_norm(x1-x3)/frob_norm(x1) < 5e-14, "sd " << frob_norm(x1-x3)/frob_norm(x1));
 });
+
+static misc::UnitTest tensor_solve_mixed("Tensor", "solve_mixed_precision", [](){
+	std::mt19937_64 rnd(0x5EED);
+	std::normal_distribution<double> dist(0.0, 1.0);
+	const size_t N = 100;
+	
+	Index i,j;
+	
+	Tensor A = Tensor::identity({N,N});
+	A *= double(N);
+	A += Tensor::random({N,N}, rnd, dist);
+	Tensor b = Tensor::random({N}, rnd, dist);
+	
+	Tensor x({N});
+	blasWrapper::solve(x.get_dense_data(), A.get_dense_data(), N, b.get_dense_data());
+	
+	Tensor residual;
+	residual(i) = A(i,j) * x(j) - b(i);
+	MTEST(frob_norm(residual)/frob_norm(b) < 1e-14, frob_norm(residual)/frob_norm(b));
+	
+	Tensor xLs;
+	xLs(i) = b(j) / A(j,i);
+	MTEST(frob_norm(x-xLs)/frob_norm(xLs) < 1e-13, frob_norm(x-xLs)/frob_norm(xLs));
+});
+
+static misc::UnitTest tensor_solve_positive_definite("Tensor", "solve_positive_definite", [](){
+	std::mt19937_64 rnd(0x5EED);
+	std::normal_distribution<double> dist(0.0, 1.0);
+	const size_t N = 60;
+	
+	Index i,j,k;
+	
+	Tensor M = Tensor::random({N,N}, rnd, dist);
+	Tensor A;
+	A(i,j) = M(i,k) * M(j,k);
+	A += Tensor::identity({N,N});
+	Tensor b = Tensor::random({N}, rnd, dist);
+	
+	Tensor x({N});
+	TEST(blasWrapper::solve_positive_definite(x.get_dense_data(), A.get_dense_data(), N, b.get_dense_data()));
+	Tensor residual;
+	residual(i) = A(i,j) * x(j) - b(i);
+	MTEST(frob_norm(residual)/frob_norm(b) < 1e-12, frob_norm(residual)/frob_norm(b));
+	
+	// An indefinite matrix is reported as such.
+	Tensor indefinite = Tensor::identity({N,N});
+	indefinite[{N-1, N-1}] = -1.0;
+	TEST(!blasWrapper::solve_positive_definite(x.get_dense_data(), indefinite.get_dense_data(), N, b.get_dense_data()));
+});
+
+static misc::UnitTest tensor_solve_symmetric("Tensor", "solve_symmetric", [](){
+	std::mt19937_64 rnd(0x5EED);
+	std::normal_distribution<double> dist(0.0, 1.0);
+	const size_t N = 60, P = 3;
+	
+	Index i,j,k;
+	
+	Tensor M = Tensor::random({N,N}, rnd, dist);
+	Tensor A;
+	A(i,j) = M(i,k) * M(j,k);
+	A += Tensor::identity({N,N});
+	Tensor B = Tensor::random({N,P}, rnd, dist);
+	
+	Tensor X({N,P});
+	TEST(blasWrapper::solve_symmetric(X.get_dense_data(), A.get_dense_data(), N, B.get_dense_data(), P));
+	Tensor residual;
+	residual(i,k) = A(i,j) * X(j,k) - B(i,k);
+	MTEST(frob_norm(residual)/frob_norm(B) < 1e-12, frob_norm(residual)/frob_norm(B));
+	
+	// Matrices that are not positive definite fall back to LDL^T
+	A *= -1.0;
+	TEST(!blasWrapper::solve_symmetric(X.get_dense_data(), A.get_dense_data(), N, B.get_dense_data(), P));
+	residual(i,k) = A(i,j) * X(j,k) - B(i,k);
+	MTEST(frob_norm(residual)/frob_norm(B) < 1e-12, frob_norm(residual)/frob_norm(B));
+});
@@ -124,6 +124,72 @@ static misc::UnitTest tensor_dim_exp("Tensor", "dimension_expansion", [](){
     TEST(C.size == 12);
 });
 
+static misc::UnitTest tensor_offset_add("Tensor", "offset_add", [](){
+	std::mt19937_64 rnd(0x5EED);
+	std::normal_distribution<value_t> dist(0.0, 1.0);
+	
+	const Tensor B = 2.0*Tensor::random({2,3,2}, rnd, dist);
+	const Tensor sB = 2.0*Tensor::random({2,3,2}, 5, rnd, dist);
+	
+	for(const Tensor& other : {B, sB}) {
+		Tensor A = Tensor::random({4,5,3}, rnd, dist);
+		Tensor sA = A.sparse_copy();
+		Tensor expected(A);
+		for(size_t i = 0; i < other.size; ++i) {
+			const Tensor::MultiIndex idx = Tensor::position_to_multiIndex(i, other.dimensions);
+			expected[{idx[0]+1, idx[1]+2, idx[2]+1}] += other[i];
+		}
+		
+		A.offset_add(other, {1,2,1});
+		sA.offset_add(other, {1,2,1});
+		TEST(approx_equal(A, expected, 1e-14));
+		TEST(approx_equal(sA, expected, 1e-14));
+	}
+});
+
+static misc::UnitTest tensor_reserved_resize("Tensor", "reserved_resize_mode", [](){
+	std::mt19937_64 rnd(0x5EED);
+	std::normal_distribution<value_t> dist(0.0, 1.0);
+	std::uniform_int_distribution<size_t> modeDist(0, 2);
+	std::uniform_int_distribution<size_t> dimDist(1, 6);
+	
+	Tensor A = Tensor::random({3,4,5}, rnd, dist);
+	Tensor B(A);
+	A.reserve(6*6*6);
+	TEST(A.capacity() == 6*6*6);
+	TEST(B.capacity() == B.size);
+	TEST(approx_equal(A, B, 1e-15));
+	
+	const value_t* const storage = A.get_unsanitized_dense_data();
+	for (size_t n = 0; n < 50; ++n) {
+		const size_t mode = modeDist(rnd);
+		const size_t newDim = dimDist(rnd);
+		const size_t oldDim = A.dimensions[mode];
+		std::uniform_int_distribution<size_t> cutDist(newDim < oldDim ? oldDim-newDim : 0, oldDim);
+		const size_t cutPos = cutDist(rnd);
+		
+		A.resize_mode(mode, newDim, cutPos);
+		B.resize_mode(mode, newDim, cutPos);
+		TEST(A.dimensions == B.dimensions);
+		TEST(approx_equal(A, B, 1e-15));
+		MTEST(A.get_unsanitized_dense_data() == storage, "resize_mode reallocated reserved storage");
+	}
+	
+	// Exceeding the capacity reallocates, but keeps the storage reserved
+	A.resize_mode(0, 6);
+	A.resize_mode(1, 6);
+	A.resize_mode(2, 6);
+	TEST(A.get_unsanitized_dense_data() == storage);
+	A.resize_mode(0, 7);
+	TEST(A.capacity() == 2*6*6*6);
+	
+	// Shared data is never modified in place
+	Tensor C(A);
+	C.resize_mode(1, 5);
+	TEST(A.dimensions[1] == 6);
+	TEST(C.dimensions[1] == 5);
+});
+
 static misc::UnitTest tensor_modify_elem("Tensor", "modify_elements", [](){
     Tensor A({4,4});
     Tensor C({2,8});
@@ -158,6 +224,21 @@ static misc::UnitTest tensor_modify_elem("Tensor", "modify_elements", [](){
     
     A.modify_diag_elements([](value_t& _entry){_entry = 0;});
     TEST(approx_entrywise_equal(A, {0,2,3,4,5,73.5*73.5*6-1.0,7,8,9,0,73.5*73.5*11-2.0,12,13,14,15,73.5*73.5*16-3.0}));
+    
+    C.modify_elements([](value_t& _entry, const size_t _position){_entry = static_cast<value_t>(_position);});
+    TEST(approx_entrywise_equal(C, {0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15}));
+    
+    C *= 2.0;
+    C.modify_elements([](value_t& _entry){_entry = _entry - 1.0;});
+    TEST(approx_entrywise_equal(C, {-1,1,3,5,7,9,11,13,15,17,19,21,23,25,27,29}));
+    
+    value_t sum = 0.0;
+    C.modify_elements([&](value_t& _entry){sum += _entry;});
+    TEST(misc::approx_equal(sum, 224.0));
+    
+    const std::function<void(value_t&)> negate = [](value_t& _entry){_entry = -_entry;};
+    C.modify_elements(negate);
+    TEST(approx_entrywise_equal(C, {1,-1,-3,-5,-7,-9,-11,-13,-15,-17,-19,-21,-23,-25,-27,-29}));
 });
 
 
@@ -18,6 +18,8 @@
 // or contact us at contact@libXerus.org.
 
 
+#include <numeric>
+
 #include<xerus.h>
 
 #include "../../include/xerus/misc/test.h"
@@ -127,6 +129,76 @@ static misc::UnitTest alg_largestEntry("Algorithm", "LargestEntry", [](){
 	}
 });
 
+static misc::UnitTest alg_largestEntries("Algorithm", "LargestEntries", [](){
+	std::mt19937_64 rnd(0xBEA3);
+	std::normal_distribution<value_t> dist (0.0, 1.0);
+	
+	const size_t k = 5;
+	for(size_t rank = 1; rank <= 4; ++rank) {
+		TTTensor X = TTTensor::random(std::vector<size_t>(8, 3), std::vector<size_t>(7, rank), rnd, dist);
+		const Tensor fullX(X);
+		
+		std::vector<size_t> order(fullX.size);
+		std::iota(order.begin(), order.end(), 0);
+		std::partial_sort(order.begin(), order.begin()+k, order.end(), [&](const size_t _a, const size_t _b){ return std::abs(fullX[_a]) > std::abs(fullX[_b]); });
+		
+		const std::vector<std::pair<size_t, value_t>> entries = X.find_largest_entries(k);
+		TEST(entries.size() == k);
+		for(size_t i = 0; i < k; ++i) {
+			MTEST(entries[i].first == order[i], "rank " << rank << " entry " << i << ": " << entries[i].first << " vs " << order[i]);
+			MTEST(misc::approx_equal(entries[i].second, fullX[entries[i].first], 1e-12), entries[i].second << " vs " << fullX[entries[i].first]);
+		}
+	}
+	
+	// Operators use the positions of the full tensor, i.e. all row indices before all column indices
+	const TTOperator A = TTOperator::random({2, 3, 4, 4, 3, 2}, {3, 3}, rnd, dist);
+	const Tensor fullA(A);
+	size_t maxPos = 0;
+	for(size_t i = 1; i < fullA.size; ++i) {
+		if(std::abs(fullA[i]) > std::abs(fullA[maxPos])) {
+			maxPos = i;
+		}
+	}
+	const std::vector<std::pair<size_t, value_t>> entries = A.find_largest_entries(1);
+	MTEST(entries[0].first == maxPos, entries[0].first << " vs " << maxPos);
+	MTEST(misc::approx_equal(entries[0].second, fullA[maxPos], 1e-12), entries[0].second << " vs " << fullA[maxPos]);
+});
+
+static misc::UnitTest alg_largestEntriesBenchmark("Algorithm", "LargestEntriesBenchmark", [](){
+	std::mt19937_64 rnd(0x7E57);
+	std::normal_distribution<value_t> dist (0.0, 1.0);
+	
+	const size_t numRuns = 10;
+	size_t hitsPower = 0, hitsBeam = 0, timePower = 0, timeBeam = 0;
+	misc::TimeMeasure clock;
+	for(size_t run = 0; run < numRuns; ++run) {
+		TTTensor X = TTTensor::random(std::vector<size_t>(10, 3), std::vector<size_t>(9, 4), rnd, dist);
+		X /= X.frob_norm();
+		const Tensor fullX(X);
+		
+		size_t posA = 0, posB = 0;
+		for(size_t i = 1; i < fullX.size; ++i) {
+			if(std::abs(fullX[i]) >= std::abs(fullX[posA])) {
+				posB = posA;
+				posA = i;
+			} else if(std::abs(fullX[i]) >= std::abs(fullX[posB])) {
+				posB = i;
+			}
+		}
+		
+		clock.step();
+		const size_t powerPos = X.find_largest_entry(std::abs(fullX[posB]/fullX[posA]), std::abs(fullX[posA]));
+		timePower += clock.step();
+		const size_t beamPos = X.find_largest_entries(1)[0].first;
+		timeBeam += clock.step();
+		
+		hitsPower += powerPos == posA ? 1 : 0;
+		hitsBeam += beamPos == posA ? 1 : 0;
+	}
+	LOG(largestEntry, "Power iteration found " << hitsPower << " of " << numRuns << " largest entries in " << timePower << " us, beam search " << hitsBeam << " in " << timeBeam << " us.");
+	TEST(hitsBeam >= hitsPower);
+});
+
 // UNIT_TEST(Algorithm, rankRange,
 //     //Random numbers
 //     std::mt19937_64 rnd;
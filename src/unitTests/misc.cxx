@@ -106,3 +106,49 @@ static misc::UnitTest misc_exc("Misc", "exceptions", [](){
 		MTEST(false, "4");
 	}
 });
+
+static misc::UnitTest misc_threads("Misc", "thread_budget", [](){
+	misc::set_thread_budget(4);
+	MTEST(misc::get_thread_budget() == 4, misc::get_thread_budget());
+	
+	{
+		const misc::ThreadBudgetSplit split(4);
+		TEST(split.teamSize == 4);
+		MTEST(misc::get_blas_threads() == 1, misc::get_blas_threads());
+		
+		size_t innerBlasThreads = 0;
+		#pragma omp parallel num_threads(2)
+		{
+			const misc::ThreadBudgetSplit nested(2);
+			#pragma omp critical
+			innerBlasThreads = std::max(innerBlasThreads, misc::get_blas_threads());
+		}
+		MTEST(innerBlasThreads == 1, innerBlasThreads);
+	}
+	
+	misc::set_thread_budget(0);
+	MTEST(misc::get_thread_budget() >= 1, misc::get_thread_budget());
+});
+
+static misc::UnitTest misc_parallel_exc("Misc", "parallel_for_exceptions", [](){
+	misc::set_thread_budget(4);
+	
+	// Exceptions thrown by the loop body must reach the caller instead of terminating the program
+	std::atomic<size_t> calls(0);
+	try {
+		misc::parallel_for(64, [&](const size_t _i){
+			calls++;
+			if (_i == 7) {
+				XERUS_THROW(misc::generic_error() << "parallel failure");
+			}
+		});
+		MTEST(false, "no exception");
+	} catch (misc::generic_error &e) {
+		MTEST(std::string(e.what()).find("parallel failure") != std::string::npos, e.what());
+	} catch (...) {
+		MTEST(false, "wrong exception");
+	}
+	MTEST(calls.load() <= 64, calls.load());
+	
+	misc::set_thread_budget(0);
+});
@@ -163,6 +163,17 @@ static misc::UnitTest sparse_mod("SparseTensor", "modify_elements", [](){
     
     A.modify_diag_elements([](value_t& _entry){_entry = 0;});
     TEST(approx_entrywise_equal(A, {0,2,3,4,5,73.5*73.5*6-1.0,7,8,9,0,73.5*73.5*11-2.0,12,13,14,15,73.5*73.5*16-3.0}));
+    
+    C[{0,3}] = 2;
+    C[{1,5}] = -4;
+    C.modify_elements([](value_t& _entry, const size_t _position){ if(_position == 1) { _entry = 1; } else if(_position == 13) { _entry = 0; } });
+    TEST(C.is_sparse());
+    TEST(C.sparsity() == 2);
+    TEST(approx_entrywise_equal(C, {0,1,0,2,0,0,0,0,0,0,0,0,0,0,0,0}));
+    
+    C.modify_elements([](value_t& _entry){_entry *= -3.0;});
+    TEST(C.sparsity() == 2);
+    TEST(approx_entrywise_equal(C, {0,-3,0,-6,0,0,0,0,0,0,0,0,0,0,0,0}));
 });
 
 
@@ -342,3 +342,196 @@ static misc::UnitTest tn_save_ntwork("TensorNetwork", "Save_Network", [](){
     res3(i,o) = res1A(i,l,m,n,j,k) * res2A(l,o,m,n,j,k);
     TEST(approx_entrywise_equal(res3, {20596523, 21531582, 46728183, 48849590}));
 });
+
+static misc::UnitTest tn_parallel_contr("TensorNetwork", "parallel_contraction_of_independent_nodes", [](){
+	std::mt19937_64 rnd(0x5EED);
+	std::normal_distribution<value_t> dist (0.0, 1.0);
+	
+	TTTensor A = TTTensor::random(std::vector<size_t>(8,4), std::vector<size_t>(7,5), rnd, dist);
+	TTTensor B = TTTensor::random(std::vector<size_t>(8,4), std::vector<size_t>(7,3), rnd, dist);
+	Index i;
+	
+	const double costBefore = TensorNetwork::minParallelContractionCost;
+	TensorNetwork::minParallelContractionCost = std::numeric_limits<double>::max();
+	Tensor serial;
+	serial() = A(i&0) * B(i&0);
+	
+	TensorNetwork::minParallelContractionCost = 0.0;
+	misc::set_thread_budget(4);
+	Tensor parallel;
+	parallel() = A(i&0) * B(i&0);
+	misc::set_thread_budget(0);
+	TensorNetwork::minParallelContractionCost = costBefore;
+	
+	MTEST(misc::approx_equal(serial[0], parallel[0], 1e-12*std::abs(serial[0])), serial[0] << " vs " << parallel[0]);
+	Tensor full;
+	full() = Tensor(A)(i&0) * Tensor(B)(i&0);
+	MTEST(misc::approx_equal(full[0], parallel[0], 1e-12*std::abs(full[0])), full[0] << " vs " << parallel[0]);
+});
+
+static misc::UnitTest tn_copy_shares("TensorNetwork", "copies_share_node_data", [](){
+	std::mt19937_64 rnd(0x5EED);
+	std::normal_distribution<value_t> dist (0.0, 1.0);
+	
+	const TTTensor A = TTTensor::random(std::vector<size_t>(5,4), std::vector<size_t>(4,3), rnd, dist);
+	const Tensor fullA(A);
+	
+	// Copies share the data of all nodes
+	TensorNetwork copy(A);
+	for(size_t i = 0; i < A.nodes.size(); ++i) {
+		TEST(copy.nodes[i].tensorObject->get_unsanitized_dense_data() == A.nodes[i].tensorObject->get_unsanitized_dense_data());
+	}
+	
+	// Evaluating, accessing entries and measuring do not duplicate the data of the original
+	const Tensor evaluated(copy);
+	TEST(approx_equal(evaluated, fullA, 1e-14));
+	TEST(misc::approx_equal(copy[7], fullA[7], 1e-14));
+	for(size_t i = 0; i < A.nodes.size(); ++i) {
+		TEST(copy.nodes[i].tensorObject->get_unsanitized_dense_data() == A.nodes[i].tensorObject->get_unsanitized_dense_data());
+	}
+	
+	// Modifying a node only duplicates the data of this node
+	(*copy.nodes[2].tensorObject)[0] += 1.0;
+	TEST(copy.nodes[2].tensorObject->get_unsanitized_dense_data() != A.nodes[2].tensorObject->get_unsanitized_dense_data());
+	TEST(copy.nodes[1].tensorObject->get_unsanitized_dense_data() == A.nodes[1].tensorObject->get_unsanitized_dense_data());
+	TEST(approx_equal(Tensor(A), fullA, 1e-14));
+	TEST(!approx_equal(Tensor(copy), fullA, 1e-14));
+});
+
+static misc::UnitTest tn_grid_contr("TensorNetwork", "grid_contraction", [](){
+	std::mt19937_64 rnd(0x5EED);
+	std::normal_distribution<value_t> dist (0.0, 1.0);
+	
+	// x^T A B x is a grid of four rows of TT components
+	TTTensor x = TTTensor::random(std::vector<size_t>(8,2), std::vector<size_t>(7,3), rnd, dist);
+	TTOperator A = TTOperator::random(std::vector<size_t>(16,2), std::vector<size_t>(7,2), rnd, dist);
+	TTOperator B = TTOperator::random(std::vector<size_t>(16,2), std::vector<size_t>(7,2), rnd, dist);
+	TTTensor y = TTTensor::random(std::vector<size_t>(5,2), std::vector<size_t>(4,2), rnd, dist);
+	Index i, j, k;
+	
+	Tensor grid;
+	grid() = x(i&0) * A(i/2, j/2) * B(j/2, k/2) * x(k&0);
+	Tensor full;
+	full() = Tensor(x)(i&0) * Tensor(A)(i/2, j/2) * Tensor(B)(j/2, k/2) * Tensor(x)(k&0);
+	MTEST(misc::approx_equal(grid[0], full[0], 1e-12*std::abs(full[0])), grid[0] << " vs " << full[0]);
+	
+	// Two unconnected parts require a dyadic product
+	Tensor product;
+	product(j&0) = x(i&0) * A(i/2, k/2) * x(k&0) * y(j&0);
+	Tensor fullProduct;
+	fullProduct(j&0) = Tensor(x)(i&0) * Tensor(A)(i/2, k/2) * Tensor(x)(k&0) * Tensor(y)(j&0);
+	TEST(approx_equal(product, fullProduct, 1e-12));
+});
+
+static misc::UnitTest tn_sliced_contr("TensorNetwork", "sliced_contraction", [](){
+	std::mt19937_64 rnd(0x5EED);
+	std::normal_distribution<value_t> dist (0.0, 1.0);
+	
+	TTTensor x = TTTensor::random(std::vector<size_t>(6,3), std::vector<size_t>(5,4), rnd, dist);
+	TTOperator A = TTOperator::random(std::vector<size_t>(12,3), std::vector<size_t>(5,3), rnd, dist);
+	TTOperator B = TTOperator::random(std::vector<size_t>(12,3), std::vector<size_t>(5,3), rnd, dist);
+	Index i, j, k;
+	
+	TensorNetwork net;
+	net(i&0) = A(i/2, j/2) * B(j/2, k/2) * x(k&0);
+	std::set<size_t> all;
+	for (size_t id = 0; id < net.nodes.size(); ++id) {
+		if (!net.nodes[id].erased) { all.insert(id); }
+	}
+	
+	const TensorNetwork::ContractionPlan unlimited = net.plan_contraction(all, 0);
+	TEST(unlimited.slicedLinks.empty());
+	TEST(unlimited.numSlices == 1);
+	TEST(unlimited.peakMemory > 0);
+	
+	const size_t budget = unlimited.peakMemory/4;
+	const TensorNetwork::ContractionPlan sliced = net.plan_contraction(all, budget);
+	TEST(!sliced.slicedLinks.empty());
+	TEST(sliced.numSlices > 1);
+	MTEST(sliced.peakMemory <= budget, sliced.peakMemory << " > " << budget);
+	TEST(sliced.order == unlimited.order);
+	
+	const Tensor expected(net);
+	
+	const size_t budgetBefore = TensorNetwork::contractionMemoryBudget;
+	TensorNetwork::contractionMemoryBudget = budget;
+	const Tensor serial(net);
+	misc::set_thread_budget(4);
+	const Tensor parallel(net);
+	misc::set_thread_budget(0);
+	TensorNetwork::contractionMemoryBudget = budgetBefore;
+	
+	TEST(approx_equal(serial, expected, 1e-12));
+	TEST(approx_equal(parallel, expected, 1e-12));
+});
+
+
+// Links the external modes k and k+degree/2, as assigning a network of degree zero would contract it immediately.
+static void close_network(TensorNetwork& _net) {
+	const size_t half = _net.degree()/2;
+	for (size_t k = 0; k < half; ++k) {
+		const TensorNetwork::Link a = _net.externalLinks[k];
+		const TensorNetwork::Link b = _net.externalLinks[k+half];
+		_net.nodes[a.other].neighbors[a.indexPosition] = TensorNetwork::Link(b.other, b.indexPosition, b.dimension, false);
+		_net.nodes[b.other].neighbors[b.indexPosition] = TensorNetwork::Link(a.other, a.indexPosition, a.dimension, false);
+	}
+	_net.externalLinks.clear();
+	_net.dimensions.clear();
+}
+
+static misc::UnitTest tn_environments("TensorNetwork", "environments", [](){
+	std::mt19937_64 rnd(0xE4F);
+	std::normal_distribution<value_t> dist (0.0, 1.0);
+	Index i, j, k, l, m;
+	
+	Tensor A = Tensor::random({2,3}, rnd, dist);
+	Tensor B = Tensor::random({3,4}, rnd, dist);
+	Tensor C = Tensor::random({4,5}, rnd, dist);
+	Tensor D = Tensor::random({5,2}, rnd, dist);
+	
+	TensorNetwork cycle;
+	cycle(i,m) = A(i,j) * B(j,k) * C(k,l) * D(l,m);
+	close_network(cycle);
+	Tensor value;
+	value() = A(i,j) * B(j,k) * C(k,l) * D(l,i);
+	TEST(approx_equal(Tensor(cycle), value, 1e-12));
+	
+	std::vector<Tensor> envs = cycle.environments();
+	TEST(envs.size() == cycle.nodes.size());
+	
+	size_t idA = cycle.nodes.size();
+	for (size_t id = 0; id < cycle.nodes.size(); ++id) {
+		if (cycle.nodes[id].erased) { continue; }
+		TEST(envs[id].dimensions == cycle.nodes[id].tensorObject->dimensions);
+		if (cycle.nodes[id].tensorObject->dimensions == A.dimensions) { idA = id; }
+		
+		// The network is linear in every node, so perturbing one node changes the value by the dot product with its environment
+		Tensor perturbation = Tensor::random(envs[id].dimensions, rnd, dist);
+		TensorNetwork perturbed(cycle);
+		*perturbed.nodes[id].tensorObject += perturbation;
+		const value_t difference = Tensor(perturbed)[0] - Tensor(cycle)[0];
+		Tensor expected;
+		expected() = envs[id](i&0) * perturbation(i&0);
+		MTEST(misc::approx_equal(difference, expected[0], 1e-10), id << ": " << difference << " vs " << expected[0]);
+	}
+	
+	// Explicitly compare against the contraction of the remaining nodes
+	TEST(idA < cycle.nodes.size());
+	Tensor envA;
+	envA(i,j) = B(j,k) * C(k,l) * D(l,i);
+	MTEST(approx_equal(envs[idA], envA, 1e-12), frob_norm(envs[idA] - envA));
+	
+	TTTensor x = TTTensor::random({3,4,3,2}, {3,4,2}, rnd, dist);
+	TTOperator op = TTOperator::random({3,4,3,2,3,4,3,2}, {2,3,2}, rnd, dist);
+	TensorNetwork quadratic;
+	quadratic(i^4, j^4) = x(i^4) * op(j^4, k^4) * x(k^4);
+	close_network(quadratic);
+	const value_t quadraticValue = Tensor(quadratic)[0];
+	envs = quadratic.environments();
+	for (size_t id = 0; id < quadratic.nodes.size(); ++id) {
+		if (quadratic.nodes[id].erased) { continue; }
+		Tensor full;
+		full() = envs[id](i&0) * (*quadratic.nodes[id].tensorObject)(i&0);
+		MTEST(misc::approx_equal(full[0], quadraticValue, 1e-10*std::abs(quadraticValue)), id << ": " << full[0] << " vs " << quadraticValue);
+	}
+});
@@ -102,3 +102,90 @@ static misc::UnitTest tn_many_access("TensorNetwork", "many_element_access", [](
 		TEST(misc::approx_equal(measurments.measuredValues[m], res[measurments.positions[m]]));
     }
 });
+
+static misc::UnitTest tt_measure_views("TT", "measure_via_views", [](){
+	std::mt19937_64 rnd(0x5EED);
+	std::normal_distribution<value_t> dist (0.0, 1.0);
+	std::uniform_int_distribution<size_t> posDist(0, 3);
+	
+	const TTTensor A = TTTensor::random(std::vector<size_t>(5,4), std::vector<size_t>(4,3), rnd, dist);
+	const TTOperator B = TTOperator::random(std::vector<size_t>(6,4), std::vector<size_t>(2,2), rnd, dist);
+	const Tensor fullA(A), fullB(B);
+	
+	SinglePointMeasurementSet measurementsA, measurementsB;
+	for(size_t m = 0; m < 40; ++m) {
+		std::vector<size_t> pos(5);
+		for(size_t& p : pos) { p = posDist(rnd); }
+		measurementsA.add(pos, 0.0);
+		pos.resize(6);
+		for(size_t& p : pos) { p = posDist(rnd); }
+		measurementsB.add(pos, 0.0);
+	}
+	
+	A.measure(measurementsA);
+	B.measure(measurementsB);
+	for(size_t m = 0; m < measurementsA.size(); ++m) {
+		TEST(misc::approx_equal(measurementsA.measuredValues[m], fullA[measurementsA.positions[m]], 1e-12));
+		TEST(misc::approx_equal(measurementsB.measuredValues[m], fullB[measurementsB.positions[m]], 1e-12));
+	}
+});
+
+static misc::UnitTest tensor_view("Tensor", "strided_views", [](){
+	std::mt19937_64 rnd(0x5EED);
+	std::normal_distribution<value_t> dist (0.0, 1.0);
+	Index i, j, k, l;
+	
+	Tensor A = Tensor::random({4,5,6}, rnd, dist);
+	A *= 2.0;
+	Tensor B = Tensor::random({6,3}, rnd, dist);
+	
+	// Fixing and restricting modes
+	TensorView slice(A);
+	slice.fix_mode(1, 2);
+	slice.restrict_mode(1, 1, 4);
+	Tensor expected = A;
+	expected.fix_mode(1, 2);
+	Tensor sliced(slice);
+	TEST(!slice.is_contiguous());
+	TEST(sliced.dimensions == std::vector<size_t>({4,4}));
+	for(size_t x = 0; x < 4; ++x) {
+		for(size_t y = 0; y < 4; ++y) {
+			TEST(misc::approx_equal(slice[{x,y}], expected[{x,y+1}], 1e-14));
+			TEST(misc::approx_equal(sliced[{x,y}], expected[{x,y+1}], 1e-14));
+		}
+	}
+	
+	// Contractions with strided and transposed views
+	Tensor res, full;
+	TensorView column(A);
+	column.fix_mode(1, 3);
+	contract(res, column, false, TensorView(B), false, 1);
+	Tensor fixed = A;
+	fixed.fix_mode(1, 3);
+	full(i,k) = fixed(i,j) * B(j,k);
+	TEST(approx_equal(res, full, 1e-14));
+	
+	contract(res, TensorView(B), true, column, true, 1);
+	full(k,i) = B(j,k) * fixed(i,j);
+	TEST(approx_equal(res, full, 1e-14));
+	
+	// A view whose modes cannot be merged is copied
+	TensorView mixed(A);
+	mixed.restrict_mode(2, 0, 3);
+	const Tensor restricted(mixed);
+	const Tensor R = Tensor::random({5,3}, rnd, dist);
+	contract(res, mixed, false, TensorView(R), false, 2);
+	full(i) = restricted(i,j,k) * R(j,k);
+	TEST(approx_equal(res, full, 1e-14));
+	
+	// Reshuffle of a view
+	reshuffle(res, slice, {1,0});
+	full(j,i) = sliced(i,j);
+	TEST(approx_equal(res, full, 1e-14));
+	
+	// Views into the result
+	Tensor C = Tensor::random({3,3}, rnd, dist);
+	full(i,k) = C(i,j) * C(j,k);
+	contract(C, TensorView(C), false, TensorView(C), false, 1);
+	TEST(approx_equal(C, full, 1e-14));
+});
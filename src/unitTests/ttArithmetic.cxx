@@ -507,3 +507,40 @@ static misc::UnitTest tt_disjoint("TT", "disjoint_product", [](){
 		dimsB.push_back(dimDist(rnd));
 	}
 });
+
+static misc::UnitTest tt_dot_gram("TT", "dot_and_gram_matrix", [](){
+	std::mt19937_64 rnd(0x6A4);
+	std::normal_distribution<value_t> dist (0.0, 1.0);
+	std::uniform_int_distribution<size_t> rankDist(1, 5);
+	Index i;
+	
+	const std::vector<size_t> dims({3, 2, 4, 3, 2});
+	std::vector<TTTensor> X;
+	for(size_t k = 0; k < 6; ++k) {
+		X.push_back(TTTensor::random(dims, {rankDist(rnd), rankDist(rnd), rankDist(rnd), rankDist(rnd)}, rnd, dist));
+	}
+	X[2] *= -2.5;
+	X.push_back(X[0]);
+	Tensor sparseComponent = X[0].get_component(2);
+	sparseComponent.use_sparse_representation();
+	X.back().set_component(2, sparseComponent);
+	TEST(X.back().get_component(2).is_sparse());
+	
+	const Tensor G = gram_matrix(X);
+	TEST(G.dimensions == std::vector<size_t>({X.size(), X.size()}));
+	for(size_t a = 0; a < X.size(); ++a) {
+		for(size_t b = 0; b < X.size(); ++b) {
+			const value_t expected = value_t(Tensor(X[a])(i&0) * Tensor(X[b])(i&0));
+			MTEST(misc::approx_equal(dot(X[a], X[b]), expected, 1e-12*std::abs(expected)+1e-14), a << " " << b << ": " << dot(X[a], X[b]) << " vs " << expected);
+			MTEST(misc::approx_equal(G[{a, b}], expected, 1e-12*std::abs(expected)+1e-14), a << " " << b << ": " << G[{a, b}] << " vs " << expected);
+		}
+	}
+	
+	// Operators and degree zero
+	const TTOperator A = TTOperator::random({2, 3, 3, 2}, {4}, rnd, dist);
+	const TTOperator B = TTOperator::random({2, 3, 3, 2}, {2}, rnd, dist);
+	TEST(misc::approx_equal(dot(A, B), value_t(Tensor(A)(i&0) * Tensor(B)(i&0)), 1e-12));
+	TEST(misc::approx_equal(gram_matrix(std::vector<TTOperator>({A, B}))[{0, 1}], dot(A, B), 1e-12));
+	const TTTensor s(2.0*Tensor::ones({})), t(-3.0*Tensor::ones({}));
+	TEST(misc::approx_equal(dot(s, t), -6.0));
+});
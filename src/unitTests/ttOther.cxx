@@ -43,6 +43,38 @@ static misc::UnitTest tt_entryprod("TT", "entrywise_product", [](){
 	TEST(approx_equal(Df, Tensor(Do2), 1e-14));
 });
 
+static misc::UnitTest tt_entryprod_round("TT", "entrywise_product_and_round", [](){
+	std::mt19937_64 rnd(0x4ADA);
+	std::normal_distribution<value_t> dist (0.0, 1.0);
+	
+	TTTensor A = TTTensor::random(std::vector<size_t>(8,3), std::vector<size_t>(7,4), rnd, dist);
+	TTTensor B = TTTensor::random(std::vector<size_t>(8,3), std::vector<size_t>(7,5), rnd, dist);
+	TTTensor exact = entrywise_product(A, B);
+	TTTensor rounded(exact);
+	rounded.round(6);
+	
+	// A truncation close to the one of the full product
+	TTTensor C = entrywise_product_and_round(A, B, 6);
+	TEST(misc::max(C.ranks()) <= 6);
+	MTEST(frob_norm(C - exact) <= 1.5*frob_norm(rounded - exact), frob_norm(C - exact) << " vs " << frob_norm(rounded - exact));
+	
+	// Squares are exactly of rank r*(r+1)/2, which the zip-up has to find through the relative threshold alone
+	TTTensor S = entrywise_product_and_round(A, A, std::numeric_limits<size_t>::max(), 1e-12);
+	TEST(misc::max(S.ranks()) <= 10);
+	MTEST(frob_norm(S - entrywise_product(A, A)) < 1e-10*frob_norm(S), frob_norm(S - entrywise_product(A, A))/frob_norm(S));
+	
+	// Operators
+	const TTOperator Ao = TTOperator::random(std::vector<size_t>(8,2), std::vector<size_t>(3,3), rnd, dist);
+	const TTOperator Bo = TTOperator::random(std::vector<size_t>(8,2), std::vector<size_t>(3,2), rnd, dist);
+	TTOperator Co = entrywise_product_and_round(Ao, Bo, 2);
+	TTOperator roundedO = entrywise_product(Ao, Bo);
+	roundedO.round(2);
+	TEST(misc::max(Co.ranks()) <= 2);
+	MTEST(frob_norm(Co - entrywise_product(Ao, Bo)) <= 1.5*frob_norm(roundedO - entrywise_product(Ao, Bo)), frob_norm(Co - entrywise_product(Ao, Bo)) << " vs " << frob_norm(roundedO - entrywise_product(Ao, Bo)));
+	Co = entrywise_product_and_round(Ao, Bo, 6);
+	TEST(approx_equal(Tensor(Co), entrywise_product(Tensor(Ao), Tensor(Bo)), 1e-12));
+});
+
 static misc::UnitTest tt_soft("TT", "soft_thresholding", [](){
     std::mt19937_64 rnd;
     std::normal_distribution<value_t> dist (0.0, 1.0);
@@ -66,3 +98,101 @@ static misc::UnitTest tt_soft("TT", "soft_thresholding", [](){
 	TEST(frob_norm(Cf - Tensor(Co))/frob_norm(Cf) < 1e-14);
 	TEST(frob_norm(Cf - Tensor(C))/frob_norm(Cf) < 1e-14);
 });
+
+static misc::UnitTest tt_parallel_ops("TT", "parallel_component_operations", [](){
+	std::mt19937_64 rnd(0xC0FFEE);
+	std::normal_distribution<value_t> dist (0.0, 1.0);
+	
+	TTTensor A = TTTensor::random(std::vector<size_t>(8,3), std::vector<size_t>(7,3), rnd, dist);
+	TTTensor B = TTTensor::random(std::vector<size_t>(8,3), std::vector<size_t>(7,2), rnd, dist);
+	
+	misc::set_thread_budget(1);
+	MTEST(misc::get_thread_budget() == 1, misc::get_thread_budget());
+	TTTensor serialProd = entrywise_product(A, B);
+	TTTensor serialSum(A);
+	serialSum += B;
+	
+	misc::set_thread_budget(0);
+	MTEST(misc::get_thread_budget() >= 1, misc::get_thread_budget());
+	TTTensor parallelProd = entrywise_product(A, B);
+	TTTensor parallelSum(A);
+	parallelSum += B;
+	
+	TEST(approx_equal(Tensor(serialProd), Tensor(parallelProd), 1e-14));
+	TEST(approx_equal(Tensor(serialSum), Tensor(parallelSum), 1e-14));
+	TEST(approx_equal(Tensor(parallelSum), Tensor(A)+Tensor(B), 1e-13));
+});
+
+static misc::UnitTest tt_dyadic_vector("TT", "dyadic_product_of_several", [](){
+	std::mt19937_64 rnd(0xD1AD);
+	std::normal_distribution<value_t> dist (0.0, 1.0);
+	
+	const auto fold = [](const std::vector<TTTensor>& _tensors) {
+		TTTensor result(_tensors.back());
+		for (size_t i = _tensors.size()-1; i > 0; --i) {
+			result = TTTensor::dyadic_product(_tensors[i-1], result);
+		}
+		return result;
+	};
+	
+	// Small factors are multiplied sequentially, large ones are reduced in parallel.
+	for (const size_t rank : {2ul, 32ul}) {
+		const std::vector<std::vector<size_t>> corePositions({{0,0,0,0,0}, {4,4,0,4,4}, {0,4,0,1,0}, {4,0,0,0,0}});
+		for (const std::vector<size_t>& positions : corePositions) {
+			std::vector<TTTensor> factors;
+			for (size_t k = 0; k < positions.size(); ++k) {
+				// The middle factor consists of a single component, its core is both first and last.
+				factors.push_back(k == 2 ? TTTensor::random({8}, std::vector<size_t>(), rnd, dist) : TTTensor::random(std::vector<size_t>(5,8), std::vector<size_t>(4,rank), rnd, dist));
+				factors.back().move_core(positions[k]);
+			}
+			
+			const TTTensor expected = fold(factors);
+			const TTTensor result = TTTensor::dyadic_product(factors);
+			
+			MTEST(result.cannonicalized == expected.cannonicalized, positions);
+			if (expected.cannonicalized) {
+				MTEST(result.corePosition == expected.corePosition, positions << ": " << result.corePosition << " vs " << expected.corePosition);
+			}
+			// The networks are too large to be compared densely, so a few entries are sampled instead.
+			std::uniform_int_distribution<size_t> indexDist(0, 7);
+			for (size_t sample = 0; sample < 10; ++sample) {
+				std::vector<size_t> index(expected.degree());
+				for (size_t& n : index) { n = indexDist(rnd); }
+				const value_t expectedEntry = expected[index];
+				MTEST(misc::approx_equal(result[index], expectedEntry, 1e-9), positions << ": " << result[index] << " vs " << expectedEntry);
+			}
+		}
+	}
+});
+
+static misc::UnitTest tt_grow_ranks("TT", "grow_ranks", [](){
+	std::mt19937_64 rnd(0x5EED);
+	std::normal_distribution<value_t> dist (0.0, 1.0);
+	
+	TTTensor A = TTTensor::random(std::vector<size_t>(6,3), std::vector<size_t>(5,2), rnd, dist);
+	TTOperator Ao = TTOperator::random(std::vector<size_t>(6,2), std::vector<size_t>(2,2), rnd, dist);
+	const Tensor Af(A);
+	const Tensor Aof(Ao);
+	
+	A.reserve_ranks(std::vector<size_t>(5,6));
+	const value_t* const storage = A.get_component(2).get_unsanitized_dense_data();
+	
+	for (size_t r = 3; r <= 6; ++r) {
+		std::vector<size_t> newRanks(5, r);
+		newRanks[4] = 3; // Cannot exceed the maximal rank at the boundary
+		A.grow_ranks(newRanks);
+		TEST(A.ranks() == newRanks);
+		A.require_correct_format();
+		TEST(approx_equal(Tensor(A), Af, 1e-14));
+	}
+	MTEST(A.get_component(2).get_unsanitized_dense_data() == storage, "grow_ranks reallocated reserved storage");
+	
+	Ao.grow_ranks({3,5});
+	TEST(Ao.ranks() == std::vector<size_t>({3,5}));
+	Ao.require_correct_format();
+	TEST(approx_equal(Tensor(Ao), Aof, 1e-14));
+	
+	// The enlarged network is still usable in arithmetic and can be rounded back
+	A.round(2);
+	TEST(approx_equal(Tensor(A), Af, 1e-12));
+});
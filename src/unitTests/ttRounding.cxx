@@ -120,3 +120,38 @@ static misc::UnitTest tt_noround("TT", "no_rounding", [](){
 	a.round(2);
 	TEST(approx_equal(Tensor(a), Tensor(b), 1e-14));
 });
+
+
+static misc::UnitTest tt_apply_round("TT", "apply_and_round", [](){
+	std::mt19937_64 rnd(0x21F);
+	std::normal_distribution<value_t> dist (0.0, 1.0);
+	Index i,j;
+	
+	const size_t d = 7;
+	const std::vector<size_t> stateDims(d, 3);
+	const std::vector<size_t> operatorDims(2*d, 3);
+	
+	// 3*identity in a rank 3 representation, so the product has ranks 21 but is exactly of the ranks of x
+	const TTOperator I = TTOperator::identity(operatorDims);
+	const TTOperator threeI = I + I + I;
+	TTTensor x = TTTensor::random(stateDims, 7, rnd, dist);
+	TTTensor y = apply_and_round(threeI, x, 7);
+	TEST(misc::max(y.ranks()) <= 7);
+	MTEST(frob_norm(y - 3.0*x) < 1e-12*frob_norm(x), frob_norm(y - 3.0*x)/frob_norm(x));
+	
+	// A truncation close to the one of the full product
+	const TTOperator A = TTOperator::random(operatorDims, 4, rnd, dist);
+	x = TTTensor::random(stateDims, 6, rnd, dist);
+	TTTensor exact;
+	exact(i&0) = A(i/2, j/2) * x(j&0);
+	TTTensor rounded(exact);
+	rounded.round(5);
+	
+	y = apply_and_round(A, x, 5);
+	TEST(misc::max(y.ranks()) <= 5);
+	MTEST(frob_norm(y - exact) <= 1.5*frob_norm(rounded - exact), frob_norm(y - exact) << " vs " << frob_norm(rounded - exact));
+	
+	// Without truncation this is the usual product
+	y = apply_and_round(A, x, 24);
+	MTEST(frob_norm(y - exact) < 1e-12*frob_norm(exact), frob_norm(y - exact)/frob_norm(exact));
+});
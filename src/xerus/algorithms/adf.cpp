@@ -26,6 +26,7 @@
  
 #include <xerus/indexedTensorMoveable.h>
 #include <xerus/misc/basicArraySupport.h>
+#include <xerus/misc/parallel.h>
 
 #ifdef _OPENMP
 	#include <omp.h>
@@ -287,6 +288,8 @@ namespace xerus {
 	
 	template<>
 	void ADFVariant::InternalSolver<SinglePointMeasurementSet>::update_backward_stack(const size_t _corePosition, const Tensor& _currentComponent) {
+		const misc::ThreadBudgetSplit threadSplit; // The measurements are processed in parallel, so BLAS gets only the remaining budget.
+		
 		REQUIRE(_currentComponent.dimensions[1] == x.dimensions[_corePosition], "IE");
 		
 		const size_t numUpdates = backwardUpdates[_corePosition].size();
@@ -303,6 +306,8 @@ namespace xerus {
 	
 	template<>
 	void ADFVariant::InternalSolver<RankOneMeasurementSet>::update_backward_stack(const size_t _corePosition, const Tensor& _currentComponent) {
+		const misc::ThreadBudgetSplit threadSplit;
+		
 		REQUIRE(_currentComponent.dimensions[1] == x.dimensions[_corePosition], "IE");
 		
 		const size_t numUpdates = backwardUpdates[_corePosition].size();
@@ -324,6 +329,8 @@ namespace xerus {
 	
 	template<>
 	void ADFVariant::InternalSolver<SinglePointMeasurementSet>::update_forward_stack( const size_t _corePosition, const Tensor& _currentComponent ) {
+		const misc::ThreadBudgetSplit threadSplit;
+		
 		REQUIRE(_currentComponent.dimensions[1] == x.dimensions[_corePosition], "IE");
 		
 		const size_t numUpdates = forwardUpdates[_corePosition].size();
@@ -340,6 +347,8 @@ namespace xerus {
 	
 	template<>
 	void ADFVariant::InternalSolver<RankOneMeasurementSet>::update_forward_stack( const size_t _corePosition, const Tensor& _currentComponent ) {
+		const misc::ThreadBudgetSplit threadSplit;
+		
 		REQUIRE(_currentComponent.dimensions[1] == x.dimensions[_corePosition], "IE");
 		
 		const size_t numUpdates = forwardUpdates[_corePosition].size();
@@ -360,6 +369,8 @@ namespace xerus {
 	
 	template<class MeasurmentSet>
 	void ADFVariant::InternalSolver<MeasurmentSet>::calculate_residual( const size_t _corePosition ) {
+		const misc::ThreadBudgetSplit threadSplit;
+		
 		Tensor currentValue({});
 		
 		// Look which side of the stack needs less calculations
@@ -429,6 +440,8 @@ namespace xerus {
 	
 	template<class MeasurmentSet>
 	inline void ADFVariant::InternalSolver<MeasurmentSet>::calculate_projected_gradient( const size_t _corePosition ) {
+		const misc::ThreadBudgetSplit threadSplit;
+		
 		const size_t localLeftRank = x.get_component(_corePosition).dimensions[0];
 		const size_t localRightRank = x.get_component(_corePosition).dimensions[2];
 		
@@ -483,6 +496,8 @@ namespace xerus {
 	
 	template<class MeasurmentSet>
 	std::vector<value_t> ADFVariant::InternalSolver<MeasurmentSet>::calculate_slicewise_norm_A_projGrad( const size_t _corePosition) {
+		const misc::ThreadBudgetSplit threadSplit;
+		
 		std::vector<value_t> normAProjGrad(x.dimensions[_corePosition], 0.0);
 		
 		Tensor currentValue({});
@@ -23,6 +23,7 @@
 */
 
 #include <xerus/misc/math.h>
+#include <xerus/misc/basicArraySupport.h>
 
 #include <xerus/algorithms/als.h>
 #include <xerus/basic.h>
@@ -32,6 +33,7 @@
 
 #include <xerus/indexedTensorMoveable.h>
 #include <xerus/indexedTensor_tensor_factorisations.h>
+#include <xerus/blasLapackWrapper.h>
 
 namespace xerus {
 
@@ -44,7 +46,20 @@ namespace xerus {
 		Tensor b(_b);
 		Tensor x;
 		Index i,j,k,l;
-		x(i&0) = b(j&0) / A(j/2, i/2);
+		if (_data.ALS.useMixedPrecision || _data.ALS.assumeSPD) {
+			// The local operator is square in both the SPD and the non-symmetric (A^T A) case.
+			x = Tensor(std::vector<size_t>(A.dimensions.begin()+long(A.degree()/2), A.dimensions.end()), Tensor::Representation::Dense, Tensor::Initialisation::None);
+			REQUIRE(A.size == x.size*x.size && b.size == x.size, "Local operator and right-hand-side do not fit together: " << A.dimensions << " vs. " << b.dimensions);
+			if (!_data.ALS.assumeSPD) {
+				blasWrapper::solve(x.override_dense_data(), A.get_dense_data(), x.size, b.get_dense_data());
+			} else if (!_data.ALS.useMixedPrecision || !blasWrapper::solve_positive_definite(x.override_dense_data(), A.get_dense_data(), x.size, b.get_dense_data())) {
+				if (!blasWrapper::solve_symmetric(x.override_dense_data(), A.get_dense_data(), x.size, b.get_dense_data())) {
+					LOG(ALS, "Local operator is not positive definite, used LDL^T instead.");
+				}
+			}
+		} else {
+			x(i&0) = b(j&0) / A(j/2, i/2);
+		}
 		if (_data.direction == Increasing) {
 			Tensor U, S;
 			for (size_t p=0; p+1<_data.ALS.sites; ++p) {
@@ -178,6 +193,83 @@ namespace xerus {
 		optimizedRange = std::pair<size_t, size_t>(firstOptimizedIndex, firstNotOptimizedIndex);
 	}
 
+	void internal::contract_stack_step(Tensor &_result, const Tensor &_stack, const std::vector<Tensor> &_components) {
+		const size_t k = _components.size();
+		REQUIRE(k >= 2 && _stack.degree() == k, "IE");
+		
+		// [r_0..r_{k-1}] * C_0 -> [r_1..r_{k-1}, n_0, cr_0]
+		Tensor current, shuffled;
+		contract(current, _stack, true, _components[0], false, 1);
+		
+		// [r_i..r_{k-1}, cr_0..cr_{i-2}, n_{i-1}, cr_{i-1}] -> [r_{i+1}..r_{k-1}, cr_0..cr_{i-1}, r_i, n_{i-1}]
+		std::vector<size_t> shuffle(k+1);
+		shuffle[0] = k-1;
+		for (size_t j = 1; j+1 < k; ++j) {
+			shuffle[j] = j-1;
+		}
+		shuffle[k-1] = k;
+		shuffle[k] = k-2;
+		
+		for (size_t i = 1; i < k; ++i) {
+			reshuffle(shuffled, current, shuffle);
+			contract(i+1 < k ? current : _result, shuffled, false, _components[i], false, 2);
+		}
+	}
+	
+	void ALSVariant::ALSAlgorithmicData::prepare_oriented_operator() {
+		REQUIRE(A, "IE");
+		orientedOperator.clear();
+		orientedOperator.reserve(A->degree()/2);
+		for (size_t pos = 0; pos < A->degree()/2; ++pos) {
+			const Tensor &AComp = A->get_component(pos);
+			if (ALS.assumeSPD) {
+				orientedOperator.push_back({reshuffle(AComp, {3,1,2,0})});
+			} else {
+				orientedOperator.push_back({reshuffle(AComp, {3,1,2,0}), reshuffle(AComp, {0,2,1,3}), reshuffle(AComp, {3,2,1,0})});
+			}
+		}
+	}
+	
+	Tensor ALSVariant::ALSAlgorithmicData::next_operator_stack(const Tensor &_stack, size_t _pos, Direction _direction) const {
+		REQUIRE(A && orientedOperator.size() == A->degree()/2, "IE");
+		const bool left = (_direction == Increasing);
+		const Tensor &xComp = x.get_component(_pos);
+		const Tensor &AComp = left ? A->get_component(_pos) : orientedOperator[_pos][0];
+		const Tensor xOriented = left ? xComp : reshuffle(xComp, {2,1,0});
+		
+		std::vector<Tensor> components;
+		if (ALS.assumeSPD) {
+			// x(r1, n1, cr1) * A(r2, n1, n2, cr2) * x(r3, n2, cr3)
+			components = {xOriented, AComp, xOriented};
+		} else {
+			// x(r1, n1, cr1) * A(r2, n2, n1, cr2) * A(r3, n2, n3, cr3) * x(r4, n3, cr4)
+			components = {xOriented, orientedOperator[_pos][left ? 1 : 2], AComp, xOriented};
+		}
+		
+		Tensor result;
+		internal::contract_stack_step(result, _stack, components);
+		return result;
+	}
+	
+	Tensor ALSVariant::ALSAlgorithmicData::next_rhs_stack(const Tensor &_stack, size_t _pos, Direction _direction) const {
+		const bool left = (_direction == Increasing);
+		const Tensor &xComp = x.get_component(_pos);
+		const Tensor &bComp = b.get_component(_pos);
+		
+		std::vector<Tensor> components;
+		if (ALS.assumeSPD || !A) {
+			// b(r1, n1, cr1) * x(r2, n1, cr2)
+			components = {left ? bComp : reshuffle(bComp, {2,1,0}), left ? xComp : reshuffle(xComp, {2,1,0})};
+		} else {
+			// b(r1, n1, cr1) * A(r2, n1, n2, cr2) * x(r3, n2, cr3)
+			components = {left ? bComp : reshuffle(bComp, {2,1,0}), left ? A->get_component(_pos) : orientedOperator[_pos][0], left ? xComp : reshuffle(xComp, {2,1,0})};
+		}
+		
+		Tensor result;
+		internal::contract_stack_step(result, _stack, components);
+		return result;
+	}
+	
 	TensorNetwork ALSVariant::ALSAlgorithmicData::localOperatorSlice(size_t _pos) {
 		//TODO optimization: create these networks without indices
 		Index cr1, cr2, cr3, cr4, r1, r2, r3, r4, n1, n2, n3;
@@ -213,7 +305,6 @@ namespace xerus {
 	
 	void ALSVariant::ALSAlgorithmicData::prepare_stacks() {
 		const size_t d=x.degree();
-		Index r1,r2;
 		
 		Tensor tmpA;
 		Tensor tmpB;
@@ -226,6 +317,10 @@ namespace xerus {
 		}
 		
 		
+		if (A) {
+			prepare_oriented_operator();
+		}
+		
 		localOperatorCache.left.emplace_back(tmpA);
 		localOperatorCache.right.emplace_back(tmpA);
 		rhsCache.left.emplace_back(tmpB);
@@ -233,19 +328,15 @@ namespace xerus {
 		
 		for (size_t i = d-1; i > optimizedRange.first + ALS.sites - 1; --i) {
 			if (A) {
-				tmpA(r1&0) = localOperatorCache.right.back()(r2&0) * localOperatorSlice(i)(r1/2, r2/2);
-				localOperatorCache.right.emplace_back(tmpA);
+				localOperatorCache.right.emplace_back(next_operator_stack(localOperatorCache.right.back(), i, Decreasing));
 			}
-			tmpB(r1&0) = rhsCache.right.back()(r2&0) * localRhsSlice(i)(r1/2, r2/2);
-			rhsCache.right.emplace_back(tmpB);
+			rhsCache.right.emplace_back(next_rhs_stack(rhsCache.right.back(), i, Decreasing));
 		}
 		for (size_t i = 0; i < optimizedRange.first; ++i) {
 			if (A) {
-				tmpA(r2&0) = localOperatorCache.left.back()(r1&0) * localOperatorSlice(i)(r1/2, r2/2);
-				localOperatorCache.left.emplace_back((tmpA));
+				localOperatorCache.left.emplace_back(next_operator_stack(localOperatorCache.left.back(), i, Increasing));
 			}
-			tmpB(r2&0) = rhsCache.left.back()(r1&0) * localRhsSlice(i)(r1/2, r2/2);
-			rhsCache.left.emplace_back(tmpB);
+			rhsCache.left.emplace_back(next_rhs_stack(rhsCache.left.back(), i, Increasing));
 		}
 	}
 	
@@ -335,8 +426,6 @@ namespace xerus {
 	}
 
 	void ALSVariant::ALSAlgorithmicData::move_to_next_index() {
-		Index r1,r2;
-		Tensor tmpA, tmpB;
 		if (direction == Increasing) {
 			REQUIRE(currIndex+ALS.sites < optimizedRange.second, "ie " << currIndex << " " << ALS.sites << " " << optimizedRange.first << " " << optimizedRange.second);
 			// Move core to next position (assumed to be done by the solver if sites > 1)
@@ -347,13 +436,11 @@ namespace xerus {
 			// Move one site to the right
 			if (A) {
 				localOperatorCache.right.pop_back();
-				tmpA(r2&0) = localOperatorCache.left.back()(r1&0) * localOperatorSlice(currIndex)(r1/2, r2/2);
-				localOperatorCache.left.emplace_back(std::move(tmpA));
+				localOperatorCache.left.emplace_back(next_operator_stack(localOperatorCache.left.back(), currIndex, Increasing));
 			}
 			
 			rhsCache.right.pop_back();
-			tmpB(r2&0) = rhsCache.left.back()(r1&0) * localRhsSlice(currIndex)(r1/2, r2/2);
-			rhsCache.left.emplace_back(std::move(tmpB));
+			rhsCache.left.emplace_back(next_rhs_stack(rhsCache.left.back(), currIndex, Increasing));
 			currIndex++;
 		} else {
 			REQUIRE(currIndex > optimizedRange.first, "ie");
@@ -365,13 +452,11 @@ namespace xerus {
 			// move one site to the left
 			if (A) {
 				localOperatorCache.left.pop_back();
-				tmpA(r1&0) = localOperatorCache.right.back()(r2&0) * localOperatorSlice(currIndex)(r1/2, r2/2);
-				localOperatorCache.right.emplace_back(std::move(tmpA));
+				localOperatorCache.right.emplace_back(next_operator_stack(localOperatorCache.right.back(), currIndex, Decreasing));
 			}
 			
 			rhsCache.left.pop_back();
-			tmpB(r1&0) = rhsCache.right.back()(r2&0) * localRhsSlice(currIndex)(r1/2, r2/2);
-			rhsCache.right.emplace_back(std::move(tmpB));
+			rhsCache.right.emplace_back(next_rhs_stack(rhsCache.right.back(), currIndex, Decreasing));
 			currIndex--;
 		}
 	}
@@ -0,0 +1,195 @@
+// Xerus - A General Purpose Tensor Library
+// Copyright (C) 2014-2016 Benjamin Huber and Sebastian Wolf. 
+// 
+// Xerus is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+// 
+// Xerus is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+// 
+// You should have received a copy of the GNU Affero General Public License
+// along with Xerus. If not, see <http://www.gnu.org/licenses/>.
+//
+// For further information on Xerus visit https://libXerus.org 
+// or contact us at contact@libXerus.org.
+
+
+/**
+* @file
+* @brief Implementation of the block ALS algorithm.
+*/
+
+#include <xerus/algorithms/blockAls.h>
+#include <xerus/algorithms/als.h>
+
+#include <xerus/misc/check.h>
+#include <xerus/misc/math.h>
+#include <xerus/misc/basicArraySupport.h>
+#include <xerus/misc/containerSupport.h>
+
+#include <xerus/basic.h>
+#include <xerus/index.h>
+#include <xerus/indexedTensorMoveable.h>
+#include <xerus/blasLapackWrapper.h>
+
+namespace xerus {
+	
+	std::vector<value_t> BlockALSVariant::sweep(const TTOperator &_A, BlockTT &_x, const std::vector<TTTensor> *_b) const {
+		const size_t d = _x.degree();
+		const size_t p = _x.blockSize;
+		REQUIRE(_A.degree() == 2*d, "Operator of degree " << _A.degree() << " cannot be applied to tensors of degree " << d);
+		REQUIRE(std::equal(_x.dimensions.begin(), _x.dimensions.end(), _A.dimensions.begin()) && std::equal(_x.dimensions.begin(), _x.dimensions.end(), _A.dimensions.begin()+long(d)), 
+				"Dimensions mismatch: " << _A.dimensions << " vs " << _x.dimensions);
+		REQUIRE(!_b || _b->size() == p, "The block size " << p << " does not fit the number of right-hand sides " << _b->size());
+		_x.require_correct_format();
+		
+		const Index r1, r2, cr1, cr2, a1, a2, n1, n2, j;
+		const size_t numRhs = _b ? p : 0;
+		for (size_t k = 0; k < numRhs; ++k) {
+			REQUIRE((*_b)[k].dimensions == _x.dimensions, "Dimensions mismatch: " << (*_b)[k].dimensions << " vs " << _x.dimensions);
+		}
+		
+		_x.move_core(0, maxRank, roundingEpsilon);
+		
+		// The stacks of the local operator only depend on the shared components, so they are computed once for the whole block
+		internal::ContractedTNCache localOperatorCache;
+		std::vector<internal::ContractedTNCache> rhsCache(numRhs);
+		localOperatorCache.left.resize(d);
+		localOperatorCache.right.resize(d);
+		localOperatorCache.left.front() = Tensor::ones({1, 1, 1});
+		localOperatorCache.right.back() = Tensor::ones({1, 1, 1});
+		for (internal::ContractedTNCache &cache : rhsCache) {
+			cache.left.resize(d);
+			cache.right.resize(d);
+			cache.left.front() = Tensor::ones({1, 1});
+			cache.right.back() = Tensor::ones({1, 1});
+		}
+		
+		// The right stacks are extended by the components with reversed modes, cf. internal::contract_stack_step, i.e. A(cr, n1, n2, r) instead of A(r, n1, n2, cr).
+		std::vector<Tensor> reversedOperator;
+		for (size_t pos = 0; pos < d; ++pos) {
+			reversedOperator.push_back(reshuffle(_A.get_component(pos), {3, 1, 2, 0}));
+		}
+		
+		// U(r1, n1, cr1) * A(r2, n1, n2, cr2) * U(r3, n2, cr3) and U(r1, n1, cr1) * b(r2, n1, cr2)
+		const auto update_left_stacks = [&](const size_t _pos) {
+			const Tensor &U = _x.components[_pos];
+			internal::contract_stack_step(localOperatorCache.left[_pos+1], localOperatorCache.left[_pos], {U, _A.get_component(_pos), U});
+			for (size_t k = 0; k < numRhs; ++k) {
+				internal::contract_stack_step(rhsCache[k].left[_pos+1], rhsCache[k].left[_pos], {U, (*_b)[k].get_component(_pos)});
+			}
+		};
+		
+		const auto update_right_stacks = [&](const size_t _pos) {
+			const Tensor V = reshuffle(_x.components[_pos], {2, 1, 0});
+			internal::contract_stack_step(localOperatorCache.right[_pos-1], localOperatorCache.right[_pos], {V, reversedOperator[_pos], V});
+			for (size_t k = 0; k < numRhs; ++k) {
+				internal::contract_stack_step(rhsCache[k].right[_pos-1], rhsCache[k].right[_pos], {V, reshuffle((*_b)[k].get_component(_pos), {2, 1, 0})});
+			}
+		};
+		
+		for (size_t pos = d-1; pos > 0; --pos) {
+			update_right_stacks(pos);
+		}
+		
+		std::vector<value_t> values(p, 0.0);
+		value_t lastEnergy = 0.0;
+		size_t halfSweepCount = 0;
+		bool increasing = true;
+		size_t pos = 0;
+		Tensor localOperator, localRhs, solution;
+		while (true) {
+			localOperator(r1, n1, r2, cr1, n2, cr2) = localOperatorCache.left[pos](r1, a1, cr1) * _A.get_component(pos)(a1, n1, n2, a2) * localOperatorCache.right[pos](r2, a2, cr2);
+			const size_t N = localOperator.dimensions[0]*localOperator.dimensions[1]*localOperator.dimensions[2];
+			solution.reset({localOperator.dimensions[0], localOperator.dimensions[1], localOperator.dimensions[2], p}, Tensor::Representation::Dense, Tensor::Initialisation::None);
+			value_t* const solutionData = solution.get_dense_data();
+			
+			if (_b) {
+				// A single factorisation of the local operator serves all right-hand sides
+				Tensor rhs(solution.dimensions, Tensor::Representation::Dense, Tensor::Initialisation::None);
+				value_t* const rhsData = rhs.get_dense_data();
+				for (size_t k = 0; k < p; ++k) {
+					localRhs(r1, n1, r2) = rhsCache[k].left[pos](r1, a1) * (*_b)[k].get_component(pos)(a1, n1, a2) * rhsCache[k].right[pos](r2, a2);
+					const value_t* const localRhsData = localRhs.get_dense_data();
+					for (size_t i = 0; i < N; ++i) {
+						rhsData[i*p + k] = localRhsData[i];
+					}
+				}
+				
+				if (!blasWrapper::solve_symmetric(solutionData, localOperator.get_dense_data(), N, rhsData, p)) {
+					LOG(BlockALS, "Local operator is not positive definite, used LDL^T instead.");
+				}
+				
+				// The energy x^T A x - 2 b^T x of the local solution is -b^T x
+				for (size_t k = 0; k < p; ++k) {
+					values[k] = 0.0;
+					for (size_t i = 0; i < N; ++i) {
+						values[k] -= rhsData[i*p + k]*solutionData[i*p + k];
+					}
+				}
+			} else {
+				REQUIRE(N >= p, "The local problem of dimension " << N << " has less than " << p << " eigenvectors. Increase the ranks of the BlockTT.");
+				std::vector<value_t> eigenvalues(N);
+				std::unique_ptr<double[]> eigenvectors(new double[N*N]);
+				misc::copy(eigenvectors.get(), localOperator.get_dense_data(), N*N);
+				blasWrapper::symmetric_eigen_decomposition_destructive(eigenvalues.data(), eigenvectors.get(), N);
+				for (size_t i = 0; i < N; ++i) {
+					misc::copy(solutionData + i*p, eigenvectors.get() + i*N, p);
+				}
+				std::copy(eigenvalues.begin(), eigenvalues.begin()+long(p), values.begin());
+			}
+			
+			_x.components[pos](r1, n1, j, r2) = solution(r1, n1, r2, j);
+			
+			const value_t energy = misc::sum(values);
+			LOG(BlockALS, "Half-sweep " << halfSweepCount << " position " << pos << ": energy " << energy);
+			if (increasing ? pos+1 == d : pos == 0) {
+				halfSweepCount += 1;
+				if (d == 1 || halfSweepCount == numHalfSweeps || std::abs(lastEnergy - energy) <= convergenceEpsilon*std::abs(energy)) {
+					break;
+				}
+				lastEnergy = energy;
+				increasing = !increasing;
+			}
+			
+			if (increasing) {
+				_x.move_core(pos+1, maxRank, roundingEpsilon);
+				update_left_stacks(pos);
+				pos += 1;
+			} else {
+				_x.move_core(pos-1, maxRank, roundingEpsilon);
+				update_right_stacks(pos);
+				pos -= 1;
+			}
+		}
+		
+		return values;
+	}
+	
+	
+	std::vector<value_t> BlockALSVariant::solve(const TTOperator &_A, BlockTT &_x, const std::vector<TTTensor> &_b) const {
+		sweep(_A, _x, &_b);
+		
+		const Index i, k;
+		std::vector<value_t> residuals;
+		for (size_t block = 0; block < _b.size(); ++block) {
+			const TTTensor x = _x.get_block(block);
+			TTTensor residual;
+			residual(i&0) = _A(i/2, k/2) * x(k&0) - _b[block](i&0);
+			residuals.push_back(frob_norm(residual)/frob_norm(_b[block]));
+		}
+		return residuals;
+	}
+	
+	
+	std::vector<value_t> BlockALSVariant::lowest_eigenpairs(const TTOperator &_A, BlockTT &_x) const {
+		return sweep(_A, _x, nullptr);
+	}
+	
+	
+	const BlockALSVariant BlockALS(0, 1e-8);
+}
@@ -46,6 +46,11 @@ namespace xerus {
 // 		std::mt19937_64 rnd(rd());
 // 		std::uniform_real_distribution<value_t> dist(0, 1);
 		
+		std::vector<size_t> largeRanks(_x.ranks());
+		for (auto &r : largeRanks) {
+			r += USER_MEASUREMENTS_PER_ITR;
+		}
+		
 		std::vector<size_t> twoR(_x.ranks());
 		for (auto &r : twoR) {
 			r *= 2;
@@ -71,19 +76,12 @@ namespace xerus {
 			value_t newAlpha = alpha;
 			
 			for (value_t beta = 1/ALPHA_CHG; beta < ALPHA_CHG*1.5; beta *= ALPHA_CHG) {
-				// Build the largeX
+				// Build the largeX, the dense part is _x with zero padded ranks
+				largeX = _x;
+				largeX.grow_ranks(largeRanks);
 				for(size_t d = 0; d < degree; ++d) {
-					Tensor& currComp = _x.component(d);
-					Tensor newComp({d == 0 ? 1 : (currComp.dimensions[0]+USER_MEASUREMENTS_PER_ITR), currComp.dimensions[1], d == degree-1 ? 1 : (currComp.dimensions[2]+USER_MEASUREMENTS_PER_ITR)});
-					
-					// Copy dense part
-					for(size_t r1 = 0; r1 < currComp.dimensions[0]; ++r1) {
-						for(size_t n = 0; n < currComp.dimensions[1]; ++n) {
-							for(size_t r2 = 0; r2 < currComp.dimensions[2]; ++r2) {
-								newComp[{r1, n, r2}] = currComp[{r1, n, r2}];
-							}
-						}
-					}
+					const Tensor& currComp = _x.get_component(d);
+					Tensor& newComp = largeX.component(d);
 					
 					// Copy sparse part
 					if (d==0) {
@@ -100,9 +98,6 @@ namespace xerus {
 							newComp[{i + currComp.dimensions[0], _measurments.positions[measurementOrder[i]][d], 0}] = 1.0;
 						}
 					}
-					
-					
-					largeX.set_component(d, newComp);
 				}
 				// one ALS sweep to 2r
 				TTTensor newX = _x;//TTTensor::random(_x.dimensions, twoR, rnd, dist);
@@ -85,17 +85,24 @@ namespace xerus {
 		baseL = _base;
 		baseL.move_core(0, true);
 		
-		Index i1,i2,j1,j2,r,s, s2;
+		// The same few contractions are executed for every component, so their index mappings are resolved only once.
+		CompiledContraction stackTimesComponent("ab,arj->brj"), closeStack("brj,brk->jk");
+		CompiledContraction matrixProduct("as,sb->ab"), matrixTimesComponent("ab,brk->ark"), componentTimesRight("ark,jk->arj");
+		CompiledContraction componentGram("arj,brj->ab"), rightTimesComponent("jri,ik->jrk"), closeRight("jrk,lrk->jl");
+		
 		std::vector<Tensor> leftStackUV;
 		std::vector<Tensor> leftStackUU;
 		Tensor tmp({1,1}, [](){return 1.0;});
 		leftStackUV.push_back(tmp);
 		leftStackUU.push_back(tmp);
+		Tensor partial;
 		for (size_t i=0; i<baseL.degree()-1; ++i) {
 			Tensor newLeft;
-			newLeft(j1,j2) = leftStackUV.back()(i1,i2) * baseL.get_component(i)(i1,r,j1) * _direction.get_component(i)(i2,r,j2);
+			stackTimesComponent(partial, leftStackUV.back(), baseL.get_component(i));
+			closeStack(newLeft, partial, _direction.get_component(i));
 			leftStackUV.emplace_back(std::move(newLeft));
-			newLeft(j1,j2) = leftStackUU.back()(i1,i2) * baseL.get_component(i)(i1,r,j1) * baseL.get_component(i)(i2,r,j2);
+			stackTimesComponent(partial, leftStackUU.back(), baseL.get_component(i));
+			closeStack(newLeft, partial, baseL.get_component(i));
 			leftStackUU.emplace_back(std::move(newLeft));
 		}
 		Tensor right(tmp);
@@ -103,21 +110,27 @@ namespace xerus {
 		std::vector<Tensor> tmpComponents;
 		for (size_t i=baseL.degree(); i>0; --i) {
 			const size_t currIdx = i-1;
-			std::unique_ptr<Tensor> newComponent(new Tensor);
 			const Tensor &UComp = baseL.get_component(currIdx);
 			Tensor V;
 			Tensor uuInv = pseudo_inverse(leftStackUU.back(), 1);
-			V(i1,r,j1) =  uuInv(i1,s)* leftStackUV.back()(s,i2) * _direction.get_component(currIdx)(i2,r,j2) * right(j1,j2);
+			// V(i1,r,j1) = uuInv(i1,s) * leftStackUV.back()(s,i2) * _direction.get_component(currIdx)(i2,r,j2) * right(j1,j2)
+			matrixProduct(UTV, uuInv, leftStackUV.back());
+			matrixTimesComponent(partial, UTV, _direction.get_component(currIdx));
+			componentTimesRight(V, partial, right);
 // 			if (i!=baseL.degree()) {
 // 				V(i1,r,j1) = V(i1,r,j1) + UComp(i1,r,s)*UTV(s,j1);
 // 			}
 			if (currIdx!=0) {
-				UTV(i1,i2) = V(i1,r,j1) * UComp(i2,r,j1);
-				V(i1,r,j1) = V(i1,r,j1) - UTV(i1,s) * UComp(s,r,j1);
+				// V(i1,r,j1) = V(i1,r,j1) - (V(i1,r,j1) * UComp(i2,r,j1)) * UComp(i2,r,j1)
+				componentGram(UTV, V, UComp);
+				matrixTimesComponent(partial, UTV, UComp);
+				V -= partial;
 			}
 			tmpComponents.emplace_back(std::move(V));
 			if (currIdx != 0) {
-				right(j1,j2) = UComp(j1,r,i1) * _direction.get_component(currIdx)(j2,r,i2) * right(i1,i2);
+				// right(j1,j2) = UComp(j1,r,i1) * _direction.get_component(currIdx)(j2,r,i2) * right(i1,i2)
+				rightTimesComponent(partial, UComp, right);
+				closeRight(right, partial, _direction.get_component(currIdx));
 			}
 			leftStackUV.pop_back();
 			leftStackUU.pop_back();
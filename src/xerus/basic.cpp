@@ -34,5 +34,6 @@ namespace xerus {
     namespace internal {
         void array_deleter_vt(value_t* const _toDelete) { delete[] _toDelete; }
         void array_deleter_st( size_t* const _toDelete) { delete[] _toDelete; }
+        void reserved_array_deleter_vt::operator()(value_t* const _toDelete) const { delete[] _toDelete; }
     }
 }
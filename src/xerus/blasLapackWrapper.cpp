@@ -59,6 +59,7 @@ extern "C"
 #include <xerus/blasLapackWrapper.h>
 #include <xerus/misc/basicArraySupport.h>
 #include <xerus/misc/math.h>
+#include <xerus/misc/parallel.h>
 
 
 
@@ -144,12 +145,15 @@ namespace xerus {
 									const double* const _B,
 									const size_t _ldb,
 									const bool _transposeB) {
+			// The BLAS II delegates assume contiguous matrices
+			const bool contiguous = _lda == (_transposeA ? _leftDim : _middleDim) && _ldb == (_transposeB ? _middleDim : _rightDim);
+			
 			//Delegate call if appropriate
-			if(_leftDim == 1) {
+			if(contiguous && _leftDim == 1) {
 				matrix_vector_product(_C, _rightDim, _alpha, _B, _middleDim, !_transposeB, _A);
-			} else if(_rightDim == 1) {
+			} else if(contiguous && _rightDim == 1) {
 				matrix_vector_product(_C, _leftDim, _alpha, _A, _middleDim, _transposeA, _B);
-			} else if(_middleDim == 1) { 
+			} else if(contiguous && _middleDim == 1) { 
 				dyadic_vector_product(_C, _leftDim, _rightDim, _alpha, _A, _B);
 			} else {
 			
@@ -219,6 +223,103 @@ namespace xerus {
 		}
 		
 		
+		// Tall-skinny matrices (m >= tallSkinnyRatio*n) are factorized with CholeskyQR2 instead of Householder reflections.
+		static const size_t tallSkinnyRatio = 8;
+		
+		// CholeskyQR2 is only used if the diagonal of the first Cholesky factor indicates a condition number below this bound, i.e. well below 1/sqrt(eps).
+		static const double maxCholeskyQRCondition = 1e6;
+		
+		// Each row block of the parallel Gram matrix and triangular solve has at least this many rows.
+		static const size_t minRowBlockSize = 1024;
+		
+		
+		/// Calculates the upper triangle of G = A^T*A for the tall _m x _n matrix A, summing the Gram matrices of row blocks in parallel.
+		static void tall_gram_matrix(double* const _G, const double* const _A, const size_t _m, const size_t _n, const bool _rowMajor, const size_t _numBlocks) {
+			const CBLAS_ORDER layout = _rowMajor ? CblasRowMajor : CblasColMajor;
+			const size_t lda = _rowMajor ? _n : _m;
+			
+			if (_numBlocks == 1) {
+				cblas_dsyrk(layout, CblasUpper, CblasTrans, static_cast<int>(_n), static_cast<int>(_m), 1.0, _A, static_cast<int>(lda), 0.0, _G, static_cast<int>(_n));
+				return;
+			}
+			
+			const std::unique_ptr<double[]> partialGrams(new double[_numBlocks*_n*_n]);
+			misc::parallel_for(_numBlocks, [&](const size_t _b) {
+				const size_t start = _b*_m/_numBlocks;
+				const size_t end = (_b+1)*_m/_numBlocks;
+				cblas_dsyrk(layout, CblasUpper, CblasTrans, static_cast<int>(_n), static_cast<int>(end-start), 1.0, _A + (_rowMajor ? start*lda : start), static_cast<int>(lda), 0.0, partialGrams.get()+_b*_n*_n, static_cast<int>(_n));
+			});
+			
+			misc::copy(_G, partialGrams.get(), _n*_n);
+			for (size_t b = 1; b < _numBlocks; ++b) {
+				misc::add_scaled(_G, 1.0, partialGrams.get()+b*_n*_n, _n*_n);
+			}
+		}
+		
+		
+		/// Calculates A = A*R^-1 for the tall _m x _n matrix A and the upper triangular _n x _n matrix R, row blocks are solved in parallel.
+		static void tall_triangular_solve(double* const _A, const double* const _R, const size_t _m, const size_t _n, const bool _rowMajor, const size_t _numBlocks) {
+			const CBLAS_ORDER layout = _rowMajor ? CblasRowMajor : CblasColMajor;
+			const size_t lda = _rowMajor ? _n : _m;
+			
+			misc::parallel_for(_numBlocks, [&](const size_t _b) {
+				const size_t start = _b*_m/_numBlocks;
+				const size_t end = (_b+1)*_m/_numBlocks;
+				cblas_dtrsm(layout, CblasRight, CblasUpper, CblasNoTrans, CblasNonUnit, static_cast<int>(end-start), static_cast<int>(_n), 1.0, _R, static_cast<int>(_n), _A + (_rowMajor ? start*lda : start), static_cast<int>(lda));
+			});
+		}
+		
+		
+		/**
+		 * Performs (Q,R) = QR(A) for the tall _m x _n matrix A (in row or column major order) using CholeskyQR2, i.e. two rounds of 
+		 * R_i = chol(A_i^T*A_i), A_{i+1} = A_i*R_i^-1. @a _Q may equal @a _A. If A is too ill-conditioned, false is returned and A is unchanged.
+		 */
+		static bool cholesky_qr2(double* const _Q, double* const _R, const double* const _A, const size_t _m, const size_t _n, const bool _rowMajor) {
+			PA_START;
+			const CBLAS_ORDER layout = _rowMajor ? CblasRowMajor : CblasColMajor;
+			const int lapackLayout = _rowMajor ? LAPACK_ROW_MAJOR : LAPACK_COL_MAJOR;
+			const size_t numBlocks = std::max(size_t(1), std::min(misc::get_thread_budget(), _m/std::max(minRowBlockSize, 4*_n)));
+			
+			const std::unique_ptr<double[]> R1(new double[_n*_n]);
+			tall_gram_matrix(R1.get(), _A, _m, _n, _rowMajor, numBlocks);
+			if (LAPACKE_dpotrf(lapackLayout, 'U', static_cast<int>(_n), R1.get(), static_cast<int>(_n)) != 0) { return false; }
+			
+			double minDiag = std::abs(R1[0]), maxDiag = std::abs(R1[0]);
+			for (size_t i = 1; i < _n; ++i) {
+				minDiag = std::min(minDiag, std::abs(R1[i*_n+i]));
+				maxDiag = std::max(maxDiag, std::abs(R1[i*_n+i]));
+			}
+			if (!(minDiag*maxCholeskyQRCondition >= maxDiag)) { return false; }
+			
+			if (_Q != _A) {
+				misc::copy(_Q, _A, _m*_n);
+			}
+			tall_triangular_solve(_Q, R1.get(), _m, _n, _rowMajor, numBlocks);
+			
+			// Second round to restore orthogonality
+			tall_gram_matrix(_R, _Q, _m, _n, _rowMajor, numBlocks);
+			if (LAPACKE_dpotrf(lapackLayout, 'U', static_cast<int>(_n), _R, static_cast<int>(_n)) != 0) {
+				if (_Q == _A) { // Restore A = Q1*R1
+					cblas_dtrmm(layout, CblasRight, CblasUpper, CblasNoTrans, CblasNonUnit, static_cast<int>(_m), static_cast<int>(_n), 1.0, R1.get(), static_cast<int>(_n), _Q, static_cast<int>(_rowMajor ? _n : _m));
+				}
+				return false;
+			}
+			tall_triangular_solve(_Q, _R, _m, _n, _rowMajor, numBlocks);
+			
+			// R = R2*R1, the lower triangles of R1 and R2 were never set.
+			for (size_t i = 1; i < _n; ++i) {
+				for (size_t j = 0; j < i; ++j) {
+					R1[_rowMajor ? i*_n+j : j*_n+i] = 0.0;
+				}
+			}
+			cblas_dtrmm(layout, CblasLeft, CblasUpper, CblasNoTrans, CblasNonUnit, static_cast<int>(_n), static_cast<int>(_n), 1.0, _R, static_cast<int>(_n), R1.get(), static_cast<int>(_n));
+			misc::copy(_R, R1.get(), _n*_n);
+			
+			PA_END("Dense LAPACK", "Cholesky QR2", misc::to_string(_m)+"x"+misc::to_string(_n));
+			return true;
+		}
+		
+		
 		std::tuple<std::unique_ptr<double[]>, std::unique_ptr<double[]>, size_t> qc(const double* const _A, const size_t _m, const size_t _n) {
 			const std::unique_ptr<double[]> tmpA(new double[_m*_n]);
 			misc::copy(tmpA.get(), _A, _m*_n);
@@ -234,6 +335,15 @@ namespace xerus {
 			REQUIRE(_n > 0, "Dimension n must be larger than zero");
 			REQUIRE(_m > 0, "Dimension m must be larger than zero");
 			
+			// Sufficiently well conditioned tall-skinny matrices have full rank and can use CholeskyQR2.
+			if (_m >= tallSkinnyRatio*_n) {
+				std::unique_ptr<double[]> Q(new double[_m*_n]);
+				std::unique_ptr<double[]> C(new double[_n*_n]);
+				if (cholesky_qr2(Q.get(), C.get(), _A, _m, _n, true)) {
+					return std::make_tuple(std::move(Q), std::move(C), _n);
+				}
+			}
+			
 			PA_START;
 			
 			// Maximal rank is used by Lapacke
@@ -308,6 +418,15 @@ namespace xerus {
 			REQUIRE(_m > 0, "Dimension n must be larger than zero");
 			REQUIRE(_n > 0, "Dimension m must be larger than zero");
 			
+			// For wide matrices A^T (column major, i.e. our A) is tall-skinny, so that A^T = Q*R by CholeskyQR2 gives A = R^T*Q^T with C = R^T.
+			if (_n >= tallSkinnyRatio*_m) {
+				std::unique_ptr<double[]> Q(new double[_n*_m]);
+				std::unique_ptr<double[]> C(new double[_m*_m]);
+				if (cholesky_qr2(Q.get(), C.get(), _A, _n, _m, false)) {
+					return std::make_tuple(std::move(C), std::move(Q), _m);
+				}
+			}
+			
 			PA_START;
 			
 			// Maximal rank is used by Lapacke
@@ -382,6 +501,10 @@ namespace xerus {
 			REQUIRE(_Q && _R && _A, "QR decomposition must not be called with null pointers: Q:" << _Q << " R: " << _R << " A: " << _A);
 			REQUIRE(_A != _R, "_A and _R must be different, otherwise qr call will fail.");
 			
+			if (_m >= tallSkinnyRatio*_n && cholesky_qr2(_Q, _R, _A, _m, _n, true)) {
+				return;
+			}
+			
 			PA_START;
 			
 			// Maximal rank is used by Lapacke
@@ -485,39 +608,212 @@ namespace xerus {
 		}
 		
 		
-	/*  TODO we need test cases for these  
-		/// Solves Ax = b for x
 		void solve( double* const _x, const double* const _A, const size_t _n, const double* const _b) {
 			const std::unique_ptr<double[]> tmpA(new double[_n*_n]);
-			array_copy(tmpA.get(), _A, _n*_n);
-			array_copy(_x, _b, _n);
+			misc::copy(tmpA.get(), _A, _n*_n);
+			
+			const std::unique_ptr<double[]> tmpB(new double[_n]);
+			misc::copy(tmpB.get(), _b, _n);
 			
-			solve_destructive(_x, tmpA.get(), _n);
+			solve_destructive(_x, tmpA.get(), _n, tmpB.get());
 		}
 		
-		/// Solves Ax = b for x
-		void solve_destructive( double* const _bToX, double* const _A, const size_t _n) {
+		
+		void solve_destructive( double* const _x, double* const _A, const size_t _n, double* const _b) {
 			REQUIRE(_n <= static_cast<size_t>(std::numeric_limits<int>::max()), "Dimension to large for BLAS/Lapack");
 			
-			START_TIME;
+			PA_START;
 			
 			std::unique_ptr<int[]> pivot(new int[_n]);
+			int iterations;
 			
-			int lapackAnswer = LAPACKE_dgesv(
+			// The LU factorisation is computed in single precision and the solution is refined in double precision.
+			// If the refinement does not converge Lapack falls back to a double precision factorisation (iterations < 0).
+			IF_CHECK( int lapackAnswer = ) LAPACKE_dsgesv(
 				LAPACK_ROW_MAJOR,
-				static_cast<int>(_n),       // Dimensions of A (nxn)
-				1,              // Number of b's, here always one
-				_A,             // The input matrix A, will be destroyed
-				static_cast<int>(_n),       // LDA
-				pivot.get(),    // Output of the pivot ordering
-				_bToX,          // Input the vector b, output the vector x
-				1 );
-			CHECK(lapackAnswer == 0, error, "Unable to solves Ax = b. Lapacke says: " << lapackAnswer);
-			
-			ADD_CALL("Solve ", to_string(_n)+"x"+to_string(_n));
-		}*/
+				static_cast<int>(_n),   // Dimensions of A (nxn)
+				1,          // Number of b's, here always one
+				_A,         // The input matrix A, will be destroyed
+				static_cast<int>(_n),   // LDA
+				pivot.get(),// Output of the pivot ordering
+				_b,         // Input the vector b
+				1,          // LDB, here always one
+				_x,         // Output the vector x
+				1,          // LDX, here always one
+				&iterations);   // Number of refinement steps or a negative value on fallback
+			CHECK(lapackAnswer == 0, error, "Unable to solve Ax = b. Lapacke says: " << lapackAnswer);
+			
+			PA_END("Dense LAPACK", iterations < 0 ? "Solve (double)" : "Solve (mixed)", misc::to_string(_n)+"x"+misc::to_string(_n));
+		}
+		
+		
+		bool solve_positive_definite( double* const _x, const double* const _A, const size_t _n, const double* const _b) {
+			const std::unique_ptr<double[]> tmpA(new double[_n*_n]);
+			misc::copy(tmpA.get(), _A, _n*_n);
+			
+			const std::unique_ptr<double[]> tmpB(new double[_n]);
+			misc::copy(tmpB.get(), _b, _n);
+			
+			return solve_positive_definite_destructive(_x, tmpA.get(), _n, tmpB.get());
+		}
+		
+		
+		bool solve_positive_definite_destructive( double* const _x, double* const _A, const size_t _n, double* const _b) {
+			REQUIRE(_n <= static_cast<size_t>(std::numeric_limits<int>::max()), "Dimension to large for BLAS/Lapack");
+			
+			PA_START;
+			
+			int iterations;
+			
+			// The Cholesky factorisation is computed in single precision and the solution is refined in double precision.
+			// If the refinement does not converge Lapack falls back to a double precision factorisation (iterations < 0).
+			const int lapackAnswer = LAPACKE_dsposv(
+				LAPACK_ROW_MAJOR,
+				'L',        // Only the lower triangle of A is referenced
+				static_cast<int>(_n),   // Dimensions of A (nxn)
+				1,          // Number of b's, here always one
+				_A,         // The input matrix A, will be destroyed
+				static_cast<int>(_n),   // LDA
+				_b,         // Input the vector b
+				1,          // LDB, here always one
+				_x,         // Output the vector x
+				1,          // LDX, here always one
+				&iterations);   // Number of refinement steps or a negative value on fallback
+			CHECK(lapackAnswer >= 0, error, "Unable to solve Ax = b. Lapacke says: " << lapackAnswer);
+			
+			PA_END("Dense LAPACK", iterations < 0 ? "Positive Definite Solve (double)" : "Positive Definite Solve (mixed)", misc::to_string(_n)+"x"+misc::to_string(_n));
+			
+			// A positive value means that A is not positive definite.
+			return lapackAnswer == 0;
+		}
 		
 	
+		bool cholesky_destructive( double* const _A, const size_t _n) {
+			REQUIRE(_n <= static_cast<size_t>(std::numeric_limits<int>::max()), "Dimension to large for BLAS/Lapack");
+			
+			PA_START;
+			
+			const int lapackAnswer = LAPACKE_dpotrf(
+				LAPACK_ROW_MAJOR,
+				'L',        // Only the lower triangle of A is referenced and overwritten by L
+				static_cast<int>(_n),   // Dimensions of A (nxn)
+				_A,         // The input matrix A, will be destroyed
+				static_cast<int>(_n));  // LDA
+			CHECK(lapackAnswer >= 0, error, "Unable to compute the Cholesky factorisation. Lapacke says: " << lapackAnswer);
+			
+			PA_END("Dense LAPACK", "Cholesky", misc::to_string(_n)+"x"+misc::to_string(_n));
+			
+			return lapackAnswer == 0;
+		}
+		
+		
+		void solve_cholesky( double* const _x, const double* const _L, const size_t _n, const double* const _b, const size_t _nrhs) {
+			REQUIRE(_n <= static_cast<size_t>(std::numeric_limits<int>::max()), "Dimension to large for BLAS/Lapack");
+			REQUIRE(_nrhs <= static_cast<size_t>(std::numeric_limits<int>::max()), "Dimension to large for BLAS/Lapack");
+			
+			PA_START;
+			
+			if (_x != _b) {
+				misc::copy(_x, _b, _n*_nrhs);
+			}
+			
+			IF_CHECK( int lapackAnswer = ) LAPACKE_dpotrs(
+				LAPACK_ROW_MAJOR,
+				'L',        // The factor is stored in the lower triangle
+				static_cast<int>(_n),   // Dimensions of L (nxn)
+				static_cast<int>(_nrhs),    // Number of b's
+				_L,         // The Cholesky factor L
+				static_cast<int>(_n),   // LDA
+				_x,         // On input b, on output x
+				static_cast<int>(_nrhs));   // LDB
+			CHECK(lapackAnswer == 0, error, "Unable to solve LL^T x = b. Lapacke says: " << lapackAnswer);
+			
+			PA_END("Dense LAPACK", "Solve (Cholesky)", misc::to_string(_n)+"x"+misc::to_string(_n));
+		}
+		
+		
+		void ldl_destructive( double* const _A, int* const _pivot, const size_t _n) {
+			REQUIRE(_n <= static_cast<size_t>(std::numeric_limits<int>::max()), "Dimension to large for BLAS/Lapack");
+			
+			PA_START;
+			
+			IF_CHECK( int lapackAnswer = ) LAPACKE_dsytrf(
+				LAPACK_ROW_MAJOR,
+				'L',        // Only the lower triangle of A is referenced and overwritten by L and D
+				static_cast<int>(_n),   // Dimensions of A (nxn)
+				_A,         // The input matrix A, will be destroyed
+				static_cast<int>(_n),   // LDA
+				_pivot);    // Output of the pivot ordering
+			CHECK(lapackAnswer >= 0, error, "Unable to compute the LDL^T factorisation. Lapacke says: " << lapackAnswer);
+			CHECK(lapackAnswer == 0, warning, "LDL^T factorisation of a singular matrix.");
+			
+			PA_END("Dense LAPACK", "LDL^T", misc::to_string(_n)+"x"+misc::to_string(_n));
+		}
+		
+		
+		void solve_ldl( double* const _x, const double* const _LD, const int* const _pivot, const size_t _n, const double* const _b, const size_t _nrhs) {
+			REQUIRE(_n <= static_cast<size_t>(std::numeric_limits<int>::max()), "Dimension to large for BLAS/Lapack");
+			REQUIRE(_nrhs <= static_cast<size_t>(std::numeric_limits<int>::max()), "Dimension to large for BLAS/Lapack");
+			
+			PA_START;
+			
+			if (_x != _b) {
+				misc::copy(_x, _b, _n*_nrhs);
+			}
+			
+			IF_CHECK( int lapackAnswer = ) LAPACKE_dsytrs(
+				LAPACK_ROW_MAJOR,
+				'L',        // The factorisation is stored in the lower triangle
+				static_cast<int>(_n),   // Dimensions of A (nxn)
+				static_cast<int>(_nrhs),    // Number of b's
+				_LD,        // The factorisation LDL^T
+				static_cast<int>(_n),   // LDA
+				_pivot,     // The pivot ordering of the factorisation
+				_x,         // On input b, on output x
+				static_cast<int>(_nrhs));   // LDB
+			CHECK(lapackAnswer == 0, error, "Unable to solve LDL^T x = b. Lapacke says: " << lapackAnswer);
+			
+			PA_END("Dense LAPACK", "Solve (LDL^T)", misc::to_string(_n)+"x"+misc::to_string(_n));
+		}
+		
+		
+		bool solve_symmetric( double* const _x, const double* const _A, const size_t _n, const double* const _b, const size_t _nrhs) {
+			const std::unique_ptr<double[]> factor(new double[_n*_n]);
+			misc::copy(factor.get(), _A, _n*_n);
+			
+			if (cholesky_destructive(factor.get(), _n)) {
+				solve_cholesky(_x, factor.get(), _n, _b, _nrhs);
+				return true;
+			}
+			
+			// A is not positive definite, the failed Cholesky factorisation destroyed the copy.
+			std::unique_ptr<int[]> pivot(new int[_n]);
+			misc::copy(factor.get(), _A, _n*_n);
+			ldl_destructive(factor.get(), pivot.get(), _n);
+			solve_ldl(_x, factor.get(), pivot.get(), _n, _b, _nrhs);
+			return false;
+		}
+		
+		
+		void symmetric_eigen_decomposition_destructive( double* const _eigenvalues, double* const _A, const size_t _n) {
+			REQUIRE(_n <= static_cast<size_t>(std::numeric_limits<int>::max()), "Dimension to large for BLAS/Lapack");
+			
+			PA_START;
+			
+			IF_CHECK( int lapackAnswer = ) LAPACKE_dsyev(
+				LAPACK_ROW_MAJOR,
+				'V',        // Compute the eigenvectors as well
+				'L',        // Only the lower triangle of A is referenced
+				static_cast<int>(_n),   // Dimensions of A (nxn)
+				_A,         // The input matrix A, on output the eigenvectors
+				static_cast<int>(_n),   // LDA
+				_eigenvalues);  // Output of the eigenvalues in ascending order
+			CHECK(lapackAnswer == 0, error, "Unable to compute the eigen decomposition. Lapacke says: " << lapackAnswer);
+			
+			PA_END("Dense LAPACK", "Symmetric eigen decomposition", misc::to_string(_n)+"x"+misc::to_string(_n));
+		}
+		
+		
 		void solve_least_squares( double* const _x, const double* const _A, const size_t _m, const size_t _n, const double* const _b){
 			const std::unique_ptr<double[]> tmpA(new double[_m*_n]);
 			misc::copy(tmpA.get(), _A, _m*_n);
@@ -0,0 +1,161 @@
+// Xerus - A General Purpose Tensor Library
+// Copyright (C) 2014-2016 Benjamin Huber and Sebastian Wolf. 
+// 
+// Xerus is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+// 
+// Xerus is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+// 
+// You should have received a copy of the GNU Affero General Public License
+// along with Xerus. If not, see <http://www.gnu.org/licenses/>.
+//
+// For further information on Xerus visit https://libXerus.org 
+// or contact us at contact@libXerus.org.
+
+
+/**
+* @file
+* @brief Implementation of the BlockTT class.
+*/
+
+#include <xerus/blockTT.h>
+
+#include <xerus/misc/check.h>
+#include <xerus/index.h>
+#include <xerus/indexedTensorMoveable.h>
+#include <xerus/indexedTensor_tensor_factorisations.h>
+
+namespace xerus {
+	BlockTT::BlockTT(const std::vector<size_t>& _dimensions, const std::vector<size_t>& _ranks, const size_t _blockSize) : dimensions(_dimensions), blockSize(_blockSize), corePosition(0) {
+		REQUIRE(!_dimensions.empty(), "A BlockTT needs at least one component.");
+		REQUIRE(_ranks.size()+1 == _dimensions.size(), "Non-matching amount of ranks given to BlockTT: " << _ranks.size() << " for " << _dimensions.size() << " dimensions.");
+		REQUIRE(_blockSize > 0, "A BlockTT needs at least one block.");
+		
+		const std::vector<size_t> targetRank = TTTensor::reduce_to_maximal_ranks(_ranks, _dimensions);
+		components.resize(_dimensions.size());
+		for(size_t i = 0; i < _dimensions.size(); ++i) {
+			const size_t leftRank = i==0 ? 1 : targetRank[i-1];
+			const size_t rightRank = i+1==_dimensions.size() ? 1 : targetRank[i];
+			if(i == 0) {
+				components[i] = Tensor({leftRank, _dimensions[i], _blockSize, rightRank});
+			} else {
+				// The first rows of an identity are right-orthogonal
+				components[i] = Tensor({leftRank, _dimensions[i], rightRank}, [&](const size_t _position) {
+					return _position%(_dimensions[i]*rightRank+1) == 0 ? 1.0 : 0.0;
+				});
+			}
+		}
+	}
+	
+	
+	BlockTT::BlockTT(const std::vector<TTTensor>& _tensors) : blockSize(_tensors.size()) {
+		REQUIRE(!_tensors.empty(), "A BlockTT needs at least one block.");
+		dimensions = _tensors.front().dimensions;
+		const size_t numComponents = dimensions.size();
+		REQUIRE(numComponents > 0, "A BlockTT needs at least one component.");
+		
+		TTTensor stacked;
+		for(size_t i = 0; i < blockSize; ++i) {
+			REQUIRE(_tensors[i].dimensions == dimensions, "All tensors of a BlockTT must have the same dimensions: " << _tensors[i].dimensions << " vs " << dimensions);
+			const TTTensor term = TTTensor::dyadic_product(_tensors[i], TTTensor(Tensor::dirac({blockSize}, i)));
+			stacked = i == 0 ? term : stacked + term;
+		}
+		stacked.round(EPSILON);
+		stacked.move_core(numComponents);
+		
+		const Index r1, r2, r3, n, j;
+		components.resize(numComponents);
+		for(size_t i = 0; i+1 < numComponents; ++i) {
+			components[i] = stacked.get_component(i);
+		}
+		components.back()(r1, n, j, r3) = stacked.get_component(numComponents-1)(r1, n, r2) * stacked.get_component(numComponents)(r2, j, r3);
+		corePosition = numComponents-1;
+		move_core(0);
+	}
+	
+	
+	size_t BlockTT::degree() const {
+		return dimensions.size();
+	}
+	
+	
+	std::vector<size_t> BlockTT::ranks() const {
+		std::vector<size_t> result;
+		for(size_t i = 0; i+1 < components.size(); ++i) {
+			result.push_back(components[i].dimensions.back());
+		}
+		return result;
+	}
+	
+	
+	TTTensor BlockTT::get_block(const size_t _block) const {
+		REQUIRE(_block < blockSize, "Block " << _block << " requested, but there are only " << blockSize);
+		TTTensor result(dimensions);
+		for(size_t i = 0; i < components.size(); ++i) {
+			if(i == corePosition) {
+				Tensor core(components[i]);
+				core.fix_mode(2, _block);
+				result.set_component(i, std::move(core));
+			} else {
+				result.set_component(i, components[i]);
+			}
+		}
+		result.assume_core_position(corePosition);
+		return result;
+	}
+	
+	
+	void BlockTT::move_core(const size_t _position, const size_t _maxRank, const double _eps) {
+		REQUIRE(_position < components.size(), "Illegal core position " << _position << " for a BlockTT of degree " << degree());
+		const Index r1, r2, r3, n, j, s1, s2;
+		Tensor U, S, Vt;
+		
+		while(corePosition < _position) {
+			(U(r1, n, s1), S(s1, s2), Vt(s2, j, r2)) = SVD(components[corePosition](r1, n, j, r2), _maxRank, _eps);
+			components[corePosition] = std::move(U);
+			components[corePosition+1](s1, n, j, r3) = S(s1, s2) * Vt(s2, j, r2) * components[corePosition+1](r2, n, r3);
+			++corePosition;
+		}
+		
+		while(corePosition > _position) {
+			(U(r1, j, s1), S(s1, s2), Vt(s2, n, r2)) = SVD(components[corePosition](r1, n, j, r2), _maxRank, _eps);
+			components[corePosition] = std::move(Vt);
+			components[corePosition-1](r1, n, j, s2) = components[corePosition-1](r1, n, r2) * U(r2, j, s1) * S(s1, s2);
+			--corePosition;
+		}
+	}
+	
+	
+	void BlockTT::require_correct_format() const {
+		REQUIRE(components.size() == dimensions.size() && corePosition < components.size(), "Wrong number of components or illegal core position.");
+		for(size_t i = 0; i < components.size(); ++i) {
+			const Tensor& comp = components[i];
+			REQUIRE(comp.degree() == (i == corePosition ? 4 : 3), "Component " << i << " has degree " << comp.degree());
+			REQUIRE(comp.dimensions[1] == dimensions[i], "Component " << i << " does not fit the external dimension " << dimensions[i]);
+			REQUIRE(i != corePosition || comp.dimensions[2] == blockSize, "The core does not fit the block size " << blockSize);
+			REQUIRE((i == 0 && comp.dimensions.front() == 1) || (i > 0 && comp.dimensions.front() == components[i-1].dimensions.back()), "Left rank of component " << i << " does not fit.");
+			REQUIRE(i+1 < components.size() || comp.dimensions.back() == 1, "The last component must have right rank one.");
+		}
+	}
+	
+	
+	void BlockTT::orthogonalize_right_part() {
+		REQUIRE(corePosition == 0, "IE");
+		const Index r1, r2, r3, n, j, s;
+		Tensor R, Q;
+		for(size_t i = components.size()-1; i > 0; --i) {
+			(R(r1, s), Q(s, n, r2)) = RQ(components[i](r1, n, r2));
+			components[i] = std::move(Q);
+			if(i == 1) {
+				components[0](r1, n, j, s) = components[0](r1, n, j, r2) * R(r2, s);
+			} else {
+				components[i-1](r1, n, s) = components[i-1](r1, n, r2) * R(r2, s);
+			}
+		}
+	}
+}
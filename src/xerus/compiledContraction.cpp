@@ -0,0 +1,148 @@
+// Xerus - A General Purpose Tensor Library
+// Copyright (C) 2014-2016 Benjamin Huber and Sebastian Wolf. 
+// 
+// Xerus is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+// 
+// Xerus is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+// 
+// You should have received a copy of the GNU Affero General Public License
+// along with Xerus. If not, see <http://www.gnu.org/licenses/>.
+//
+// For further information on Xerus visit https://libXerus.org 
+// or contact us at contact@libXerus.org.
+
+/**
+ * @file
+ * @brief Implementation of the CompiledContraction class.
+ */
+
+#include <cctype>
+
+#include <xerus/compiledContraction.h>
+
+#include <xerus/misc/check.h>
+
+namespace xerus {
+	
+	namespace {
+		/// @brief Returns the shuffle that moves the modes @a _from to the order @a _to (given as one letter per mode), or an empty vector if they coincide.
+		std::vector<size_t> shuffle_between(const std::string& _from, const std::string& _to) {
+			if(_from == _to) { return std::vector<size_t>(); }
+			std::vector<size_t> shuffle(_from.size());
+			for(size_t i = 0; i < _from.size(); ++i) {
+				shuffle[i] = _to.find(_from[i]);
+			}
+			return shuffle;
+		}
+		
+		/// @brief Returns the letters of @a _modes that appear in @a _filter, in the order of @a _modes.
+		std::string restrict_to(const std::string& _modes, const std::string& _filter) {
+			std::string result;
+			for(const char c : _modes) {
+				if(_filter.find(c) != std::string::npos) { result.push_back(c); }
+			}
+			return result;
+		}
+		
+		bool is_valid_mode_list(const std::string& _modes) {
+			for(size_t i = 0; i < _modes.size(); ++i) {
+				if(!std::isalpha(_modes[i]) || _modes.find(_modes[i], i+1) != std::string::npos) { return false; }
+			}
+			return true;
+		}
+	}
+	
+	
+	CompiledContraction::CompiledContraction(const std::string& _expression) : expression(_expression) {
+		const size_t comma = _expression.find(',');
+		const size_t arrow = _expression.find("->");
+		REQUIRE(comma != std::string::npos && arrow != std::string::npos && comma < arrow, "Invalid contraction expression '" << _expression << "', expected e.g. 'ij,jk->ik'.");
+		
+		const std::string lhsModes = _expression.substr(0, comma);
+		const std::string rhsModes = _expression.substr(comma+1, arrow-comma-1);
+		const std::string resultModes = _expression.substr(arrow+2);
+		REQUIRE(is_valid_mode_list(lhsModes) && is_valid_mode_list(rhsModes) && is_valid_mode_list(resultModes), "Invalid contraction expression '" << _expression << "', every mode has to be a single letter that appears at most once per tensor.");
+		
+		for(const char c : resultModes) {
+			REQUIRE((lhsModes.find(c) != std::string::npos) != (rhsModes.find(c) != std::string::npos), "Mode '" << c << "' of the result has to appear in exactly one operand of '" << _expression << "'.");
+		}
+		for(const char c : lhsModes + rhsModes) {
+			REQUIRE(resultModes.find(c) != std::string::npos || (lhsModes.find(c) != std::string::npos && rhsModes.find(c) != std::string::npos), "Mode '" << c << "' of '" << _expression << "' is neither contracted nor part of the result. Traces are not supported.");
+		}
+		
+		// The result of contract() has the open modes of the first operand in front, so if the result begins with a mode of the rhs the operands are swapped.
+		swapOperands = !resultModes.empty() && rhsModes.find(resultModes[0]) != std::string::npos;
+		const std::string& firstModes = swapOperands ? rhsModes : lhsModes;
+		const std::string& secondModes = swapOperands ? lhsModes : rhsModes;
+		
+		const std::string firstOpen = restrict_to(resultModes, firstModes);
+		const std::string secondOpen = restrict_to(resultModes, secondModes);
+		std::string contracted;
+		for(const char c : firstModes) {
+			if(resultModes.find(c) == std::string::npos) { contracted.push_back(c); }
+		}
+		numContracted = contracted.size();
+		
+		// Use the first operand as it is if possible, otherwise order the contracted modes as in the second one to possibly save its reshuffle.
+		if(firstModes == firstOpen + contracted) {
+			firstTrans = false;
+		} else if(firstModes == contracted + firstOpen) {
+			firstTrans = true;
+		} else {
+			contracted = restrict_to(secondModes, contracted);
+			firstTrans = false;
+			firstShuffle = shuffle_between(firstModes, firstOpen + contracted);
+		}
+		
+		if(secondModes == contracted + secondOpen) {
+			secondTrans = false;
+		} else if(secondModes == secondOpen + contracted) {
+			secondTrans = true;
+		} else {
+			secondTrans = false;
+			secondShuffle = shuffle_between(secondModes, contracted + secondOpen);
+		}
+		
+		resultShuffle = shuffle_between(firstOpen + secondOpen, resultModes);
+	}
+	
+	
+	void CompiledContraction::operator()(Tensor& _result, const Tensor& _lhs, const Tensor& _rhs) {
+		const Tensor* first = swapOperands ? &_rhs : &_lhs;
+		const Tensor* second = swapOperands ? &_lhs : &_rhs;
+		
+		IF_CHECK(
+			const size_t comma = expression.find(',');
+			REQUIRE(_lhs.degree() == comma && _rhs.degree() == expression.find("->")-comma-1, "Degrees of the operands do not match the expression '" << expression << "': " << _lhs.dimensions << " and " << _rhs.dimensions);
+		)
+		
+		if(!firstShuffle.empty()) {
+			reshuffle(firstBuffer, *first, firstShuffle);
+			first = &firstBuffer;
+		}
+		if(!secondShuffle.empty()) {
+			reshuffle(secondBuffer, *second, secondShuffle);
+			second = &secondBuffer;
+		}
+		
+		if(resultShuffle.empty()) {
+			contract(_result, *first, firstTrans, *second, secondTrans, numContracted);
+		} else {
+			contract(resultBuffer, *first, firstTrans, *second, secondTrans, numContracted);
+			reshuffle(_result, resultBuffer, resultShuffle);
+		}
+	}
+	
+	
+	Tensor CompiledContraction::operator()(const Tensor& _lhs, const Tensor& _rhs) {
+		Tensor result;
+		operator()(result, _lhs, _rhs);
+		return result;
+	}
+}
@@ -22,6 +22,9 @@
  * @brief Implementation of some basic greedy contraction heuristics.
  */
 
+#include <queue>
+#include <tuple>
+
 #include <xerus/misc/check.h>
 
 #include <xerus/contractionHeuristic.h>
@@ -32,8 +35,8 @@ namespace xerus {
 		
 		template<double (*scoreFct)(double, double, double, double, double)>
 		void greedy_heuristic(double &_bestCost, std::vector<std::pair<size_t,size_t>> &_contractions, TensorNetwork _network) {
-			// estimated cost to calculate this heuristic is
-			// numNodes * numNodes * 2*avgEdgesPerNode = 2 * numNodes * numEdges
+			// estimated cost to calculate this heuristic is (ignoring the logarithmic factor of the priority queue)
+			// numEdges * 2*avgEdgesPerNode for the initial scores plus the same again for rescoring every contracted node
 			double numNodes = 0, numEdges = 0;
 			for (size_t i=0; i<_network.nodes.size(); ++i) {
 				if (!_network.nodes[i].erased) {
@@ -42,53 +45,101 @@ namespace xerus {
 				}
 			}
 			// if the best solution is only about twice as costly as the calculation of this heuristic, then don't bother
-			if (_bestCost < 2 * 2 * numNodes * numEdges) return;
+			if (_bestCost < 2 * 2 * 2 * numEdges * numEdges / numNodes) return;
+			
+			// Calculates n,m,r and thereby the score and cost of contracting node _id1 with node _id2
+			const auto score = [&](const size_t _id1, const size_t _id2, double &_cost) {
+				double m=1,n=1,r=1;
+				for (const TensorNetwork::Link &l : _network.nodes[_id1].neighbors) {
+					if (l.links(_id2)) {
+						r *= static_cast<double>(l.dimension);
+					} else {
+						m *= static_cast<double>(l.dimension);
+					}
+				}
+				for (const TensorNetwork::Link &l : _network.nodes[_id2].neighbors) {
+					if (!l.links(_id1)) {
+						n *= static_cast<double>(l.dimension);
+					}
+				}
+				_cost = contraction_cost(m,n,r,0.0,0.0);
+				return scoreFct(m,n,r,0.0,0.0);
+			};
+			
+			// The candidates are the pairs of linked nodes, ordered by score and then by ids. As the score of a pair only depends on its two nodes,
+			// a contraction only invalidates the candidates of the resulting node. Those are detected lazily via the node versions.
+			struct Candidate {
+				double score, cost;
+				size_t id1, id2, version1, version2;
+			};
+			const auto worse = [](const Candidate &_a, const Candidate &_b) {
+				return std::tie(_a.score, _a.id1, _a.id2) > std::tie(_b.score, _b.id1, _b.id2);
+			};
+			std::priority_queue<Candidate, std::vector<Candidate>, decltype(worse)> candidates(worse);
+			std::vector<size_t> versions(_network.nodes.size(), 0);
+			
+			const auto add_candidates = [&](const size_t _id, const bool _onlyLater) {
+				for (const TensorNetwork::Link &l : _network.nodes[_id].neighbors) {
+					if (l.external || l.other == _id || (_onlyLater && l.other < _id)) { continue; }
+					Candidate c;
+					c.id1 = std::min(_id, l.other);
+					c.id2 = std::max(_id, l.other);
+					c.version1 = versions[c.id1];
+					c.version2 = versions[c.id2];
+					c.score = score(c.id1, c.id2, c.cost);
+					candidates.push(c);
+				}
+			};
+			
+			for (size_t i = 0; i < _network.nodes.size(); ++i) {
+				if (!_network.nodes[i].erased) {
+					add_candidates(i, true);
+				}
+			}
 			
-			double bestScore, ourCost=0;
 			double ourFinalCost=0;
 			std::vector<std::pair<size_t,size_t>> ourContractions;
-			size_t bestId1, bestId2;
-			do {
-				bestScore = std::numeric_limits<double>::max();
-				for (size_t i = 0; i < _network.nodes.size(); ++i) {
-					if (_network.nodes[i].erased) continue;
-					TensorNetwork::TensorNode &ni = _network.nodes[i];
-					for (size_t j = i+1; j < _network.nodes.size(); ++j) {
-						if (_network.nodes[j].erased) continue;
-						TensorNetwork::TensorNode &nj = _network.nodes[j];
-						/* possible candidate (i.e. link to a later node) */
-						/* calculate n,m,r */
-						double m=1,n=1,r=1;
-						for (size_t d = 0; d < ni.degree(); ++d) {
-							if (ni.neighbors[d].other == j) {
-								r *= static_cast<double>(ni.neighbors[d].dimension);
-							} else {
-								m *= static_cast<double>(ni.neighbors[d].dimension);
-							}
-						}
-						for (size_t d = 0; d < nj.degree(); ++d) {
-							if (nj.neighbors[d].other != i) {
-								n *= static_cast<double>(nj.neighbors[d].dimension);
+			for (size_t remaining = static_cast<size_t>(numNodes); remaining > 1; --remaining) {
+				while (!candidates.empty() && (_network.nodes[candidates.top().id1].erased || _network.nodes[candidates.top().id2].erased
+						|| candidates.top().version1 != versions[candidates.top().id1] || candidates.top().version2 != versions[candidates.top().id2])) {
+					candidates.pop();
+				}
+				
+				size_t bestId1 = 0, bestId2 = 0;
+				double ourCost = 0;
+				if (!candidates.empty()) {
+					bestId1 = candidates.top().id1;
+					bestId2 = candidates.top().id2;
+					ourCost = candidates.top().cost;
+					candidates.pop();
+				} else {
+					// No linked nodes remain, i.e. the network is disconnected and a dyadic product is required.
+					double bestScore = std::numeric_limits<double>::max();
+					for (size_t i = 0; i < _network.nodes.size(); ++i) {
+						if (_network.nodes[i].erased) continue;
+						for (size_t j = i+1; j < _network.nodes.size(); ++j) {
+							if (_network.nodes[j].erased) continue;
+							double tmpCost;
+							const double tmpScore = score(i, j, tmpCost);
+							if (tmpScore < bestScore) {
+								bestScore = tmpScore;
+								ourCost = tmpCost;
+								bestId1 = i;
+								bestId2 = j;
 							}
 						}
-						double tmpscore = scoreFct(m,n,r,0.0,0.0);
-						if (tmpscore < bestScore) {
-							bestScore = tmpscore;
-							ourCost = contraction_cost(m,n,r,0.0,0.0);
-							bestId1 = i;
-							bestId2 = j;
-						}
 					}
 				}
-				if (bestScore < std::numeric_limits<double>::max()) {
-					ourFinalCost += ourCost;
-					if (ourFinalCost > _bestCost) {
-						return;
-					}
-					ourContractions.emplace_back(bestId1,bestId2);
-					_network.contract(bestId1,bestId2);
+				
+				ourFinalCost += ourCost;
+				if (ourFinalCost > _bestCost) {
+					return;
 				}
-			} while (bestScore < std::numeric_limits<double>::max());
+				ourContractions.emplace_back(bestId1,bestId2);
+				_network.contract(bestId1,bestId2);
+				versions[bestId1] += 1;
+				add_candidates(bestId1, false);
+			}
 			if (ourFinalCost < _bestCost) {
 				_bestCost = ourFinalCost;
 				_contractions = std::move(ourContractions);
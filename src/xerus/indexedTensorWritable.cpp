@@ -90,10 +90,10 @@ namespace xerus {
 
 			const size_t res = cpy.tensorObject->contract(all);
 			
-			std::vector<Index> externalOrder;
-			for(size_t i = 0; i < cpy.tensorObject->nodes[res].neighbors.size(); ++i) { externalOrder.emplace_back(); }
+			std::vector<Index> externalOrder(cpy.tensorObject->nodes[res].neighbors.size());
 			
 			std::vector<Index> internalOrder;
+			internalOrder.reserve(externalOrder.size());
 			for(const TensorNetwork::Link& link: cpy.tensorObject->nodes[res].neighbors) {
 				REQUIRE(link.external, "Internal Error " << link.other << " " << link.indexPosition);
 				internalOrder.emplace_back(externalOrder[link.indexPosition]);
@@ -101,6 +101,7 @@ namespace xerus {
 			
 			assign_indices(get_eval_degree(cpy.indices));
 			std::vector<Index> outOrder;
+			outOrder.reserve(externalOrder.size());
 			for (const Index &idx : indices) {
 				REQUIRE(misc::contains(cpy.indices, idx), "Every index on the LHS must appear somewhere on the RHS, here: " << cpy.indices << ' ' << indices);
 				size_t spanSum = 0;
@@ -26,6 +26,7 @@
 #include <xerus/measurments.h>
  
 #include <xerus/misc/sort.h>
+#include <xerus/misc/parallel.h>
 
 #include <xerus/index.h>
 #include <xerus/tensor.h> 
@@ -143,6 +144,7 @@ namespace xerus {
 		}
 		
 		// TODO beautify
+		const misc::ThreadBudgetSplit threadSplit;
 		#pragma omp parallel reduction(+: residualNorm, measurementNorm)
 		{
 			std::unique_ptr<Tensor[]> stackMem(new Tensor[degree()+1]);
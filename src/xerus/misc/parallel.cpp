@@ -0,0 +1,130 @@
+// Xerus - A General Purpose Tensor Library
+// Copyright (C) 2014-2016 Benjamin Huber and Sebastian Wolf. 
+// 
+// Xerus is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+// 
+// Xerus is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+// 
+// You should have received a copy of the GNU Affero General Public License
+// along with Xerus. If not, see <http://www.gnu.org/licenses/>.
+//
+// For further information on Xerus visit https://libXerus.org 
+// or contact us at contact@libXerus.org.
+
+/**
+ * @file
+ * @brief Implementation of the parallel execution helpers.
+ */
+
+#include <xerus/misc/parallel.h>
+#include <xerus/misc/performanceAnalysis.h>
+#include <xerus/misc/stringUtilities.h>
+
+#ifdef _OPENMP
+	#include <omp.h>
+#endif
+
+// Thread control of the common BLAS implementations. These are weak so that xerus can be linked against any BLAS.
+extern "C" {
+	void openblas_set_num_threads(int) __attribute__((weak));
+	int openblas_get_num_threads() __attribute__((weak));
+	void MKL_Set_Num_Threads(int) __attribute__((weak));
+	int MKL_Get_Max_Threads() __attribute__((weak));
+	void bli_thread_set_num_threads(long) __attribute__((weak));
+	long bli_thread_get_num_threads() __attribute__((weak));
+}
+
+namespace xerus {
+	namespace misc {
+		
+		/// @brief Thread budget set by the user, zero means the OpenMP default.
+		static size_t threadBudget = 0;
+		
+		/// @brief Defaults of OpenMP and BLAS before the first budget was set, zero if not yet saved.
+		static size_t defaultOmpThreads = 0;
+		static size_t defaultBlasThreads = 0;
+		
+		void set_thread_budget(const size_t _numThreads) {
+			if (defaultBlasThreads == 0) {
+				defaultBlasThreads = get_blas_threads();
+				#ifdef _OPENMP
+					defaultOmpThreads = static_cast<size_t>(omp_get_max_threads());
+				#endif
+			}
+			
+			threadBudget = _numThreads;
+			const size_t numThreads = _numThreads > 0 ? _numThreads : defaultOmpThreads;
+			#ifdef _OPENMP
+				if (numThreads > 0) { omp_set_num_threads(static_cast<int>(numThreads)); }
+			#endif
+			set_blas_threads(_numThreads > 0 ? _numThreads : defaultBlasThreads);
+		}
+		
+		size_t get_thread_budget() {
+			#ifdef _OPENMP
+				return threadBudget > 0 ? threadBudget : static_cast<size_t>(omp_get_max_threads());
+			#else
+				return 1;
+			#endif
+		}
+		
+		void set_blas_threads(const size_t _numThreads) {
+			const int numThreads = static_cast<int>(std::max(_numThreads, size_t(1)));
+			if (openblas_set_num_threads) { openblas_set_num_threads(numThreads); }
+			if (MKL_Set_Num_Threads) { MKL_Set_Num_Threads(numThreads); }
+			if (bli_thread_set_num_threads) { bli_thread_set_num_threads(numThreads); }
+		}
+		
+		size_t get_blas_threads() {
+			long numThreads = 1;
+			if (openblas_get_num_threads) {
+				numThreads = openblas_get_num_threads();
+			} else if (MKL_Get_Max_Threads) {
+				numThreads = MKL_Get_Max_Threads();
+			} else if (bli_thread_get_num_threads) {
+				numThreads = bli_thread_get_num_threads();
+			}
+			return static_cast<size_t>(std::max(numThreads, 1l));
+		}
+		
+		
+		static bool in_parallel_region() {
+			#ifdef _OPENMP
+				return omp_in_parallel() != 0;
+			#else
+				return false;
+			#endif
+		}
+		
+		ThreadBudgetSplit::ThreadBudgetSplit(const size_t _teamSize) : 
+			teamSize(std::max(_teamSize, size_t(1))), 
+			active(teamSize > 1 && !in_parallel_region()), 
+			previousBlasThreads(active ? get_blas_threads() : 0),
+			#ifdef PERFORMANCE_ANALYSIS
+				startTime(uTime())
+			#else
+				startTime(0)
+			#endif
+		{
+			if (active) {
+				set_blas_threads(get_thread_budget()/teamSize);
+			}
+		}
+		
+		ThreadBudgetSplit::~ThreadBudgetSplit() {
+			if (active) {
+				#ifdef PERFORMANCE_ANALYSIS
+					const size_t pa_startTime = startTime;
+					PA_END("Threads", "Budget split", to_string(teamSize)+" OpenMP x "+to_string(get_blas_threads())+" BLAS");
+				#endif
+				set_blas_threads(previousBlasThreads);
+			}
+		}
+	}
+}
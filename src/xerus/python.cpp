@@ -597,6 +597,13 @@ BOOST_PYTHON_MODULE(libxerus) {
 		.def(self -= self)
 	;
 	def("entrywise_product", static_cast<TTTensor (*)(const TTTensor&, const TTTensor&)>(&entrywise_product));
+	def("entrywise_product_and_round", static_cast<TTTensor (*)(TTTensor, TTTensor, const std::vector<size_t>&, const double)>(&entrywise_product_and_round),
+		(arg("A"), arg("B"), arg("maxRanks"), arg("epsilon")=EPSILON));
+	def("entrywise_product_and_round", static_cast<TTTensor (*)(TTTensor, TTTensor, const size_t, const double)>(&entrywise_product_and_round),
+		(arg("A"), arg("B"), arg("maxRank"), arg("epsilon")=EPSILON));
+	def("dot", static_cast<value_t (*)(const TTTensor&, const TTTensor&)>(&dot));
+	VECTOR_TO_PY(TTTensor, "TTTensorVector");
+	def("gram_matrix", static_cast<Tensor (*)(const std::vector<TTTensor>&)>(&gram_matrix));
 	
 	class_<TTOperator, bases<TensorNetwork>>("TTOperator")
 		.def(init<const Tensor&, optional<value_t, size_t>>())
@@ -666,6 +673,14 @@ BOOST_PYTHON_MODULE(libxerus) {
 		.def("transpose", &TTOperator::transpose<>)
 	;
 	def("entrywise_product", static_cast<TTOperator (*)(const TTOperator&, const TTOperator&)>(&entrywise_product));
+	def("entrywise_product_and_round", static_cast<TTOperator (*)(TTOperator, TTOperator, const std::vector<size_t>&, const double)>(&entrywise_product_and_round),
+		(arg("A"), arg("B"), arg("maxRanks"), arg("epsilon")=EPSILON));
+	def("entrywise_product_and_round", static_cast<TTOperator (*)(TTOperator, TTOperator, const size_t, const double)>(&entrywise_product_and_round),
+		(arg("A"), arg("B"), arg("maxRank"), arg("epsilon")=EPSILON));
+	def("apply_and_round", static_cast<TTTensor (*)(const TTOperator&, TTTensor, const std::vector<size_t>&, const double)>(&apply_and_round),
+		(arg("A"), arg("x"), arg("maxRanks"), arg("epsilon")=EPSILON));
+	def("apply_and_round", static_cast<TTTensor (*)(const TTOperator&, TTTensor, const size_t, const double)>(&apply_and_round),
+		(arg("A"), arg("x"), arg("maxRank"), arg("epsilon")=EPSILON));
 	
 	// ------------------------------------------------------------- Algorithms
 	VECTOR_TO_PY(PerformanceData::DataPoint, "PerfDataVector");
@@ -43,6 +43,12 @@
 namespace xerus {
 	size_t Tensor::sparsityFactor = 4;
 	
+	/// @brief Minimal number of entries for which the elementwise loops are distributed among several threads.
+	static const size_t minParallelSize = 1ul<<15;
+	
+	/// @brief Minimal number of multiplications of a contraction for which delta structures of the operands are exploited.
+	static const size_t minStructuredContractionCost = 1ul<<15;
+	
 	/*- - - - - - - - - - - - - - - - - - - - - - - - - - Constructors - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -*/
 	
 	Tensor::Tensor(const Representation _representation) : Tensor(DimensionTuple({}), _representation) { } 
@@ -255,9 +261,11 @@ namespace xerus {
 	
 	size_t Tensor::count_non_zero_entries(const value_t _eps) const {
 		if(is_dense()) {
+			const value_t* const dataPtr = denseData.get();
 			size_t count = 0;
+			#pragma omp parallel for simd reduction(+: count) schedule(static) if(size > minParallelSize)
 			for(size_t i = 0; i < size; ++i) {
-				if(std::abs(denseData.get()[i]) > _eps ) { count++; }
+				if(std::abs(dataPtr[i]) > _eps ) { count++; }
 			}
 			return count;
 		} else {
@@ -272,9 +280,13 @@ namespace xerus {
 	
 	bool Tensor::all_entries_valid() const {
 		if(is_dense()) {
+			const value_t* const dataPtr = denseData.get();
+			bool valid = true;
+			#pragma omp parallel for reduction(&&: valid) schedule(static) if(size > minParallelSize)
 			for(size_t i = 0; i < size; ++i) {
-				if(!std::isfinite(denseData.get()[i])) { return false; } 
+				valid = valid && std::isfinite(dataPtr[i]);
 			}
+			return valid;
 		} else {
 			for(const auto& entry : *sparseData) {
 				if(!std::isfinite(entry.second)) {return false; } 
@@ -652,7 +664,42 @@ namespace xerus {
 		const size_t newsize = blockCount*newStepSize;
 		
 		if(is_dense()) {
-			std::unique_ptr<value_t[]> tmpData(new value_t[newsize]);
+			const internal::reserved_array_deleter_vt* const reservation = std::get_deleter<internal::reserved_array_deleter_vt>(denseData);
+			
+			if(reservation && denseData.unique() && newsize <= reservation->capacity) {
+				value_t* const data = denseData.get();
+				
+				if (_newDim > oldDim) { // Add new slates, blocks only move backwards so start with the last one
+					const size_t insertBlockSize = (_newDim-oldDim)*dimStepSize;
+					const size_t preBlockSize = _cutPos*dimStepSize;
+					const size_t postBlockSize = (oldDim-_cutPos)*dimStepSize;
+					for (size_t i = blockCount; i > 0; --i) {
+						value_t* const currData = data+(i-1)*newStepSize;
+						const value_t* const oldData = data+(i-1)*oldStepSize;
+						misc::copy_inplace(currData+preBlockSize+insertBlockSize, oldData+preBlockSize, postBlockSize);
+						misc::copy_inplace(currData, oldData, preBlockSize);
+						misc::set_zero(currData+preBlockSize, insertBlockSize);
+					}
+				} else { // Remove slates, blocks only move forwards so start with the first one
+					const size_t removedBlockSize = (oldDim-_newDim)*dimStepSize;
+					const size_t preBlockSize = (_cutPos-(oldDim-_newDim))*dimStepSize;
+					const size_t postBlockSize = (oldDim-_cutPos)*dimStepSize;
+					for (size_t i = 0; i < blockCount; ++i) {
+						value_t* const currData = data+i*newStepSize;
+						const value_t* const oldData = data+i*oldStepSize;
+						misc::copy_inplace(currData, oldData, preBlockSize);
+						misc::copy_inplace(currData+preBlockSize, oldData+preBlockSize+removedBlockSize, postBlockSize);
+					}
+				}
+				
+				dimensions[_mode] = _newDim;
+				size = newsize;
+				return;
+			}
+			
+			// Reserved storage stays reserved, growing geometrically such that repeated resizes are amortized.
+			const size_t newCapacity = reservation ? std::max(newsize, 2*reservation->capacity) : newsize;
+			std::unique_ptr<value_t[]> tmpData(new value_t[newCapacity]);
 			
 			if (_newDim > oldDim) { // Add new slates
 				const size_t insertBlockSize = (_newDim-oldDim)*dimStepSize;
@@ -698,7 +745,11 @@ namespace xerus {
 					}
 				}
 			}
-			denseData.reset(tmpData.release(), internal::array_deleter_vt);
+			if(reservation) {
+				denseData.reset(tmpData.release(), internal::reserved_array_deleter_vt{newCapacity});
+			} else {
+				denseData.reset(tmpData.release(), internal::array_deleter_vt);
+			}
 		
 		} else {
 			std::unique_ptr<std::map<size_t, value_t>> tmpData(new std::map<size_t, value_t>());
@@ -740,6 +791,23 @@ namespace xerus {
 	}
 	
 	
+	void Tensor::reserve(const size_t _capacity) {
+		if(!is_dense() || _capacity <= capacity()) { return; }
+		
+		std::unique_ptr<value_t[]> tmpData(new value_t[_capacity]);
+		misc::copy(tmpData.get(), denseData.get(), size);
+		denseData.reset(tmpData.release(), internal::reserved_array_deleter_vt{_capacity});
+	}
+	
+	
+	size_t Tensor::capacity() const {
+		if(!is_dense()) { return 0; }
+		
+		const internal::reserved_array_deleter_vt* const reservation = std::get_deleter<internal::reserved_array_deleter_vt>(denseData);
+		return reservation ? reservation->capacity : size;
+	}
+	
+	
 	void Tensor::fix_mode(const size_t _mode, const size_t _slatePosition) {
 		REQUIRE(_slatePosition < dimensions[_mode], "The given slatePosition must be smaller than the corresponding dimension. Here " << _slatePosition << " >= " << dimensions[_mode]);
 		
@@ -892,42 +960,12 @@ namespace xerus {
 	
 	
 	void Tensor::modify_elements(const std::function<void(value_t&)>& _f) {
-		ensure_own_data_and_apply_factor();
-		if(is_dense()) {
-			for(size_t i = 0; i < size; ++i) { _f(at(i)); }
-		} else {
-			for(size_t i = 0; i < size; ++i) {
-				value_t val = cat(i);
-				const value_t oldVal = val;
-				_f(val);
-				if(misc::hard_not_equal(val, 0.0)) {
-					at(i) = val;
-				} else if( misc::hard_not_equal(oldVal, 0.0)) {
-					IF_CHECK( size_t succ =) sparseData->erase(i);
-					REQUIRE(succ == 1, "Internal Error");
-				}
-			}
-		}
+		modify_elements<const std::function<void(value_t&)>&>(_f);
 	}
 	
 
 	void Tensor::modify_elements(const std::function<void(value_t&, const size_t)>& _f) {
-		ensure_own_data_and_apply_factor();
-		if(is_dense()) {
-			for(size_t i = 0; i < size; ++i) { _f(at(i), i); }
-		} else {
-			for(size_t i = 0; i < size; ++i) {
-				value_t val = cat(i);
-				const value_t oldVal = val;
-				_f(val, i);
-				if(misc::hard_not_equal(val, 0.0)) {
-					at(i) = val;
-				} else if( misc::hard_not_equal(oldVal, 0.0)) {
-					IF_CHECK( size_t succ =) sparseData->erase(i);
-					REQUIRE(succ == 1, "Internal Error");
-				}
-			}
-		}
+		modify_elements<const std::function<void(value_t&, const size_t)>&>(_f);
 	}
 	
 	
@@ -1009,27 +1047,37 @@ namespace xerus {
 				inPosition += blockSize;
 				outPosition += stepSizes[index];
 				while(i%multStep == 0) {
-					outPosition -= dimensions[index]*stepSizes[index]; // "reset" current index to 0
+					outPosition -= _other.dimensions[index]*stepSizes[index]; // "reset" current index to 0
 					--index;							// Advance to next index
 					outPosition += stepSizes[index];	// increase next index
-					multStep *= dimensions[index];		// next stepSize
+					multStep *= _other.dimensions[index];		// next stepSize
 				}
 				
 				misc::add_scaled(outPosition, _other.factor, inPosition, blockSize);
 			}
 		} else {
 			const size_t offset = multiIndex_to_position(_offsets, dimensions);
+			const std::vector<size_t> stepSizes = get_step_sizes(dimensions);
+			
+			// Maps a position in _other to the corresponding position in this tensor without constructing a MultiIndex per entry.
+			const auto translate_position = [&](size_t _position) {
+				size_t newPos = offset;
+				for(size_t d = degree(); d > 0; --d) {
+					newPos += (_position%_other.dimensions[d-1])*stepSizes[d-1];
+					_position /= _other.dimensions[d-1];
+				}
+				return newPos;
+			};
+			
 			if(is_dense()) {
 				value_t* const dataPtr = get_dense_data();
 				for(const auto& entry : _other.get_unsanitized_sparse_data()) {
-					const size_t newPos = multiIndex_to_position(position_to_multiIndex(entry.first, _other.dimensions), dimensions) + offset;
-					dataPtr[newPos] += _other.factor*entry.second;
+					dataPtr[translate_position(entry.first)] += _other.factor*entry.second;
 				}
 			} else {
 				std::map<size_t, value_t>& data = get_sparse_data(); 
 				for(const auto& entry : _other.get_unsanitized_sparse_data()) {
-					const size_t newPos = multiIndex_to_position(position_to_multiIndex(entry.first, _other.dimensions), dimensions) + offset;
-					data[newPos] += _other.factor*entry.second;
+					data[translate_position(entry.first)] += _other.factor*entry.second;
 				}
 			}
 		}
@@ -1260,6 +1308,219 @@ namespace xerus {
 	
 	
 	/*- - - - - - - - - - - - - - - - - - - - - - - - - - External functions - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -*/
+	/**
+	 * @brief Checks whether the tensor is a scaled product of kronecker deltas and unit vectors, as created by Tensor::identity, kronecker, dirac and ones.
+	 * @details Each mode is assigned a group, all modes of a group are required to have the same value (which is a fixed position for dirac tensors).
+	 * The check costs O(sparsity) for sparse and usually O(1) for dense tensors, as only constant dense tensors are considered.
+	 * @param _group the group of each mode.
+	 * @param _fixed for each group the fixed position or size_t(-1) if the group is a delta.
+	 * @param _scale the common value of all nonzero entries, including the factor of the tensor.
+	 */
+	#pragma GCC diagnostic push
+	#pragma GCC diagnostic ignored "-Wfloat-equal"
+	static bool find_delta_structure(const Tensor& _tensor, std::vector<size_t>& _group, std::vector<size_t>& _fixed, value_t& _scale) {
+		const size_t degree = _tensor.degree();
+		if(degree == 0 || _tensor.size < 2) { return false; }
+		
+		_group.resize(degree);
+		if(!_tensor.is_sparse()) {
+			// ones: Every mode is a separate delta group, i.e. unrestricted
+			const value_t* const data = _tensor.get_unsanitized_dense_data();
+			for(size_t i = 1; i < _tensor.size; ++i) {
+				if(data[i] != data[0]) { return false; }
+			}
+			for(size_t i = 0; i < degree; ++i) { _group[i] = i; }
+			_fixed.assign(degree, size_t(-1));
+			_scale = _tensor.factor*data[0];
+			return true;
+		}
+		
+		const std::map<size_t, value_t>& data = _tensor.get_unsanitized_sparse_data();
+		if(data.empty()) { return false; }
+		const value_t value = data.begin()->second;
+		for(const std::pair<const size_t, value_t>& entry : data) {
+			if(entry.second != value) { return false; }
+		}
+		_scale = _tensor.factor*value;
+		
+		// dirac: Every mode is a separate group with a fixed position
+		if(data.size() == 1) {
+			_fixed = Tensor::position_to_multiIndex(data.begin()->first, _tensor.dimensions);
+			for(size_t i = 0; i < degree; ++i) { _group[i] = i; }
+			return true;
+		}
+		
+		// kronecker: A single delta group containing all modes
+		const std::vector<size_t> stepSizes = get_step_sizes(_tensor.dimensions);
+		const size_t diagonalStep = misc::sum(stepSizes);
+		const size_t diagonalSize = misc::min(_tensor.dimensions);
+		if(data.size() == diagonalSize && std::all_of(data.begin(), data.end(), [&](const std::pair<const size_t, value_t>& _entry){ return _entry.first%diagonalStep == 0 && _entry.first/diagonalStep < diagonalSize; })) {
+			_group.assign(degree, 0);
+			_fixed.assign(1, size_t(-1));
+			return true;
+		}
+		
+		// identity: The delta groups {i, d/2+i}
+		if(degree%2 == 0) {
+			const size_t half = degree/2;
+			size_t identitySize = 1;
+			for(size_t i = 0; i < half; ++i) {
+				identitySize *= std::min(_tensor.dimensions[i], _tensor.dimensions[half+i]);
+			}
+			if(data.size() != identitySize) { return false; }
+			
+			for(const std::pair<const size_t, value_t>& entry : data) {
+				for(size_t i = 0; i < half; ++i) {
+					if((entry.first/stepSizes[i])%_tensor.dimensions[i] != (entry.first/stepSizes[half+i])%_tensor.dimensions[half+i]) { return false; }
+				}
+			}
+			for(size_t i = 0; i < half; ++i) { _group[i] = _group[half+i] = i; }
+			_fixed.assign(half, size_t(-1));
+			return true;
+		}
+		
+		return false;
+	}
+	#pragma GCC diagnostic pop
+	
+	
+	/// @brief Calls _f(a, b) for every tuple of values in [0, _counts[i]), where a and b are the offsets of the tuple with respect to the two given strides.
+	template<class function_t>
+	static void for_each_tuple(const std::vector<size_t>& _counts, const std::vector<size_t>& _stridesA, const std::vector<size_t>& _stridesB, const function_t& _f) {
+		if(misc::product(_counts) == 0) { return; }
+		std::vector<size_t> tuple(_counts.size(), 0);
+		size_t a = 0, b = 0;
+		while(true) {
+			_f(a, b);
+			size_t i = 0;
+			for(; i < tuple.size(); ++i) {
+				if(++tuple[i] < _counts[i]) {
+					a += _stridesA[i]; b += _stridesB[i];
+					break;
+				}
+				a -= (_counts[i]-1)*_stridesA[i]; b -= (_counts[i]-1)*_stridesB[i];
+				tuple[i] = 0;
+			}
+			if(i == tuple.size()) { return; }
+		}
+	}
+	
+	
+	/**
+	 * @brief Contracts a dense tensor with a tensor of delta structure (cf. find_delta_structure) without a matrix product.
+	 * @details The contraction reduces to slicing (dirac), diagonal extraction (kronecker, identity) or summation (ones) of the dense tensor followed by
+	 * a broadcast into the remaining modes of the structured tensor, i.e. it costs O(entries read + size of the result) instead of a GEMM.
+	 * @param _result dense data of the result, which is ordered as in contract().
+	 * @param _structuredFirst whether @a _structured is the lhs of the contraction.
+	 * @param _structuredFront whether the contracted modes are the leading modes of @a _structured.
+	 * @param _otherFront whether the contracted modes are the leading modes of @a _other.
+	 * @return FALSE (without touching the result) if @a _structured has no delta structure.
+	 */
+	static bool contract_delta_structured(value_t* const _result, const Tensor& _structured, const bool _structuredFirst, const bool _structuredFront, const Tensor& _other, const bool _otherFront, const size_t _numIndices) {
+		if(_other.is_sparse() || _numIndices == 0) { return false; }
+		
+		std::vector<size_t> group, fixed;
+		value_t scale;
+		if(!find_delta_structure(_structured, group, fixed, scale)) { return false; }
+		
+		const size_t structuredRemain = _structured.degree() - _numIndices;
+		const size_t contractStart = _structuredFront ? 0 : structuredRemain;
+		const size_t remainStart = _structuredFront ? _numIndices : 0;
+		const size_t contractSize = misc::product(_structured.dimensions, contractStart, contractStart+_numIndices);
+		const size_t otherRemainSize = _other.size/contractSize;
+		const size_t structuredRemainSize = _structured.size/contractSize;
+		
+		// Strides of the contracted modes in _other and of the remaining modes of _structured in the result
+		const std::vector<size_t> contractSteps = get_step_sizes(Tensor::DimensionTuple(_structured.dimensions.begin()+long(contractStart), _structured.dimensions.begin()+long(contractStart+_numIndices)));
+		const std::vector<size_t> remainSteps = get_step_sizes(Tensor::DimensionTuple(_structured.dimensions.begin()+long(remainStart), _structured.dimensions.begin()+long(remainStart+structuredRemain)));
+		const size_t otherContractFactor = _otherFront ? otherRemainSize : 1;
+		const size_t otherRemainStep = _otherFront ? 1 : contractSize;
+		const size_t resultRemainFactor = _structuredFirst ? otherRemainSize : 1;
+		const size_t resultOtherStep = _structuredFirst ? 1 : structuredRemainSize;
+		
+		const size_t numGroups = fixed.size();
+		std::vector<size_t> count(numGroups, std::numeric_limits<size_t>::max()), otherStride(numGroups, 0), resultStride(numGroups, 0);
+		std::vector<bool> contracted(numGroups, false), remains(numGroups, false);
+		for(size_t i = 0; i < _structured.degree(); ++i) {
+			const size_t g = group[i];
+			count[g] = std::min(count[g], _structured.dimensions[i]);
+			if(i >= contractStart && i < contractStart+_numIndices) {
+				contracted[g] = true;
+				otherStride[g] += contractSteps[i-contractStart]*otherContractFactor;
+			} else {
+				remains[g] = true;
+				resultStride[g] += remainSteps[i-remainStart]*resultRemainFactor;
+			}
+		}
+		
+		// Fixed groups contribute only a constant offset
+		size_t otherOffset = 0, resultOffset = 0;
+		for(size_t g = 0; g < numGroups; ++g) {
+			if(fixed[g] != size_t(-1)) {
+				otherOffset += fixed[g]*otherStride[g];
+				resultOffset += fixed[g]*resultStride[g];
+				count[g] = 1;
+				otherStride[g] = resultStride[g] = 0;
+			}
+		}
+		
+		// Groups that are contracted and remain become a single mode of the reduced tensor.
+		std::vector<size_t> reduceCounts, reduceOther, reduceReduced, expandCounts, expandReduced, expandResult;
+		size_t reducedSize = 1;
+		for(size_t g = 0; g < numGroups; ++g) {
+			const size_t reducedStride = contracted[g] && remains[g] ? reducedSize*otherRemainSize : 0;
+			if(contracted[g]) {
+				reduceCounts.push_back(count[g]);
+				reduceOther.push_back(otherStride[g]);
+				reduceReduced.push_back(reducedStride);
+			}
+			if(remains[g]) {
+				expandCounts.push_back(count[g]);
+				expandReduced.push_back(reducedStride);
+				expandResult.push_back(resultStride[g]);
+			}
+			if(contracted[g] && remains[g]) { reducedSize *= count[g]; }
+		}
+		
+		// Slicing, diagonal extraction and summation of the dense tensor. The loop over the remaining modes of _other is innermost if these are contiguous.
+		const value_t* const otherData = _other.get_unsanitized_dense_data() + otherOffset;
+		std::unique_ptr<value_t[]> reduced(new value_t[reducedSize*otherRemainSize]);
+		misc::set_zero(reduced.get(), reducedSize*otherRemainSize);
+		std::vector<std::pair<size_t, size_t>> offsets;
+		for_each_tuple(reduceCounts, reduceOther, reduceReduced, [&](const size_t _otherPos, const size_t _reducedPos) { offsets.emplace_back(_otherPos, _reducedPos); });
+		if(otherRemainStep == 1) {
+			for(const std::pair<size_t, size_t>& o : offsets) {
+				misc::add(reduced.get() + o.second, otherData + o.first, otherRemainSize);
+			}
+		} else {
+			for(size_t r = 0; r < otherRemainSize; ++r) {
+				for(const std::pair<size_t, size_t>& o : offsets) {
+					reduced[o.second + r] += otherData[o.first + r*otherRemainStep];
+				}
+			}
+		}
+		
+		// Broadcast into the remaining modes of the structured tensor
+		scale *= _other.factor;
+		value_t* const resultData = _result + resultOffset;
+		misc::set_zero(_result, otherRemainSize*structuredRemainSize);
+		offsets.clear();
+		for_each_tuple(expandCounts, expandReduced, expandResult, [&](const size_t _reducedPos, const size_t _resultPos) { offsets.emplace_back(_reducedPos, _resultPos); });
+		if(resultOtherStep == 1) {
+			for(const std::pair<size_t, size_t>& o : offsets) {
+				misc::copy_scaled(resultData + o.second, scale, reduced.get() + o.first, otherRemainSize);
+			}
+		} else {
+			for(size_t r = 0; r < otherRemainSize; ++r) {
+				for(const std::pair<size_t, size_t>& o : offsets) {
+					resultData[o.second + r*resultOtherStep] = scale*reduced[o.first + r];
+				}
+			}
+		}
+		return true;
+	}
+	
+	
 	void contract(Tensor& _result, const Tensor& _lhs, const bool _lhsTrans, const Tensor& _rhs, const bool _rhsTrans, const size_t _numIndices) {
 		REQUIRE(_numIndices <= _lhs.degree() && _numIndices <= _rhs.degree(), "Cannot contract more indices than both tensors have. we have: " 
 			<< _lhs.degree() << " and " << _rhs.degree() << " but want to contract: " << _numIndices);
@@ -1317,7 +1578,11 @@ namespace xerus {
 		}
 		
 		
-		if(!_lhs.is_sparse() && !_rhs.is_sparse()) { // Full * Full => Full
+		if(!sparseResult && leftDim*midDim*rightDim >= minStructuredContractionCost && (contract_delta_structured(usedResult->override_dense_data(), _lhs, true, _lhsTrans, _rhs, !_rhsTrans, _numIndices) 
+				|| contract_delta_structured(usedResult->override_dense_data(), _rhs, false, !_rhsTrans, _lhs, _lhsTrans, _numIndices))) {
+			// Structured (identity, kronecker, dirac, ones) * Full => Full
+			
+		} else if(!_lhs.is_sparse() && !_rhs.is_sparse()) { // Full * Full => Full
 			blasWrapper::matrix_matrix_product(usedResult->override_dense_data(), leftDim, rightDim, _lhs.factor*_rhs.factor, 
 											_lhs.get_unsanitized_dense_data(), _lhsTrans, midDim, 
 											_rhs.get_unsanitized_dense_data(), _rhsTrans);
@@ -1431,6 +1696,165 @@ namespace xerus {
 		_rhs.reset(std::move(newDim), std::move(_rhsData));
 	}
 	
+	/// @brief Rows and columns of a matrix that form one independent block, i.e. one connected component of the non-zero pattern.
+	struct MatrixBlock {
+		std::vector<size_t> rows;
+		std::vector<size_t> cols;
+	};
+	
+	
+	/**
+	 * @brief Finds the independent blocks of the @a _lhsSize x @a _rhsSize matricisation of @a _input.
+	 * @details Two rows (or columns) belong to the same block if they are connected via a chain of non-zero entries. 
+	 * Components without any non-zero entry are omitted, so the matrix is exactly the (permuted) direct sum of the returned blocks.
+	 * Such a structure appears e.g. for tensors that conserve a quantum number. Returns no blocks if splitting is not worthwhile.
+	 */
+	static std::vector<MatrixBlock> find_matrix_blocks(const Tensor& _input, const size_t _lhsSize, const size_t _rhsSize) {
+		const size_t numEntries = _input.is_dense() ? _input.count_non_zero_entries(0.0) : _input.get_unsanitized_sparse_data().size();
+		if(numEntries == 0 || 2*numEntries > _lhsSize*_rhsSize) { return std::vector<MatrixBlock>(); }
+		
+		// Union-find over the rows [0, lhsSize) and the columns [lhsSize, lhsSize+rhsSize)
+		std::vector<size_t> parent(_lhsSize+_rhsSize);
+		for(size_t i = 0; i < parent.size(); ++i) { parent[i] = i; }
+		
+		const auto find = [&](size_t _node) {
+			while(parent[_node] != _node) {
+				parent[_node] = parent[parent[_node]];
+				_node = parent[_node];
+			}
+			return _node;
+		};
+		
+		std::vector<bool> used(_lhsSize+_rhsSize, false);
+		const auto join = [&](const size_t _position) {
+			const size_t row = _position/_rhsSize;
+			const size_t col = _lhsSize + _position%_rhsSize;
+			used[row] = true;
+			used[col] = true;
+			const size_t rootRow = find(row);
+			const size_t rootCol = find(col);
+			if(rootRow != rootCol) { parent[std::max(rootRow, rootCol)] = std::min(rootRow, rootCol); }
+		};
+		
+		if(_input.is_dense()) {
+			const value_t* const data = _input.get_unsanitized_dense_data();
+			for(size_t i = 0; i < _input.size; ++i) {
+				if(misc::hard_not_equal(data[i], 0.0)) { join(i); }
+			}
+		} else {
+			for(const auto& entry : _input.get_unsanitized_sparse_data()) {
+				if(misc::hard_not_equal(entry.second, 0.0)) { join(entry.first); }
+			}
+		}
+		
+		std::vector<MatrixBlock> blocks;
+		std::vector<size_t> blockOfRoot(_lhsSize+_rhsSize, ~0ul);
+		size_t blockArea = 0;
+		for(size_t i = 0; i < _lhsSize+_rhsSize; ++i) {
+			if(!used[i]) { continue; }
+			const size_t root = find(i);
+			if(blockOfRoot[root] == ~0ul) {
+				blockOfRoot[root] = blocks.size();
+				blocks.emplace_back();
+			}
+			if(i < _lhsSize) {
+				blocks[blockOfRoot[root]].rows.push_back(i);
+			} else {
+				blocks[blockOfRoot[root]].cols.push_back(i-_lhsSize);
+			}
+		}
+		
+		for(const MatrixBlock& block : blocks) {
+			blockArea += block.rows.size()*block.cols.size();
+		}
+		
+		// Only worthwhile if the blocks are considerably smaller than the whole matrix
+		if(2*blockArea > _lhsSize*_rhsSize) { return std::vector<MatrixBlock>(); }
+		
+		return blocks;
+	}
+	
+	
+	/**
+	 * @brief Calculates the SVD of the @a _lhsSize x @a _rhsSize matricisation of @a _input block by block.
+	 * @details The singular vectors of all blocks are sorted by their singular values and scattered into @a _U (with leading dimension @a _ldu) and @a _Vt.
+	 * All other entries of @a _U and @a _Vt are set to zero.
+	 * @returns the number of calculated singular values, i.e. the sum of the ranks of all blocks.
+	 */
+	static size_t blockwise_svd(value_t* const _U, const size_t _ldu, value_t* const _S, value_t* const _Vt, const Tensor& _input, const size_t _lhsSize, const size_t _rhsSize, const std::vector<MatrixBlock>& _blocks) {
+		// Local position of each row/column within its block
+		std::vector<size_t> blockOfRow(_lhsSize, ~0ul), localRow(_lhsSize), localCol(_rhsSize);
+		std::vector<std::unique_ptr<value_t[]>> blockData(_blocks.size());
+		for(size_t b = 0; b < _blocks.size(); ++b) {
+			for(size_t i = 0; i < _blocks[b].rows.size(); ++i) {
+				blockOfRow[_blocks[b].rows[i]] = b;
+				localRow[_blocks[b].rows[i]] = i;
+			}
+			for(size_t j = 0; j < _blocks[b].cols.size(); ++j) {
+				localCol[_blocks[b].cols[j]] = j;
+			}
+			blockData[b].reset(new value_t[_blocks[b].rows.size()*_blocks[b].cols.size()]);
+			misc::set_zero(blockData[b].get(), _blocks[b].rows.size()*_blocks[b].cols.size());
+		}
+		
+		const auto scatter = [&](const size_t _position, const value_t _value) {
+			const size_t row = _position/_rhsSize;
+			const size_t b = blockOfRow[row];
+			if(b == ~0ul) { return; }
+			blockData[b][localRow[row]*_blocks[b].cols.size() + localCol[_position%_rhsSize]] = _value;
+		};
+		
+		if(_input.is_dense()) {
+			const value_t* const data = _input.get_unsanitized_dense_data();
+			for(size_t i = 0; i < _input.size; ++i) {
+				if(misc::hard_not_equal(data[i], 0.0)) { scatter(i, data[i]); }
+			}
+		} else {
+			for(const auto& entry : _input.get_unsanitized_sparse_data()) {
+				scatter(entry.first, entry.second);
+			}
+		}
+		
+		// SVD of each block
+		std::vector<std::unique_ptr<value_t[]>> blockU(_blocks.size()), blockS(_blocks.size()), blockVt(_blocks.size());
+		std::vector<std::tuple<value_t, size_t, size_t>> singularValues;
+		for(size_t b = 0; b < _blocks.size(); ++b) {
+			const size_t m = _blocks[b].rows.size();
+			const size_t n = _blocks[b].cols.size();
+			const size_t k = std::min(m, n);
+			blockU[b].reset(new value_t[m*k]);
+			blockS[b].reset(new value_t[k]);
+			blockVt[b].reset(new value_t[k*n]);
+			blasWrapper::svd_destructive(blockU[b].get(), blockS[b].get(), blockVt[b].get(), blockData[b].get(), m, n);
+			for(size_t i = 0; i < k; ++i) {
+				singularValues.emplace_back(blockS[b][i], b, i);
+			}
+		}
+		
+		std::stable_sort(singularValues.begin(), singularValues.end(), [](const std::tuple<value_t, size_t, size_t>& _a, const std::tuple<value_t, size_t, size_t>& _b){
+			return std::get<0>(_a) > std::get<0>(_b);
+		});
+		
+		// Assemble the factors
+		misc::set_zero(_U, _lhsSize*_ldu);
+		misc::set_zero(_Vt, singularValues.size()*_rhsSize);
+		for(size_t r = 0; r < singularValues.size(); ++r) {
+			const size_t b = std::get<1>(singularValues[r]);
+			const size_t idx = std::get<2>(singularValues[r]);
+			const size_t k = std::min(_blocks[b].rows.size(), _blocks[b].cols.size());
+			_S[r] = std::get<0>(singularValues[r]);
+			for(size_t i = 0; i < _blocks[b].rows.size(); ++i) {
+				_U[_blocks[b].rows[i]*_ldu + r] = blockU[b][i*k + idx];
+			}
+			for(size_t j = 0; j < _blocks[b].cols.size(); ++j) {
+				_Vt[r*_rhsSize + _blocks[b].cols[j]] = blockVt[b][idx*_blocks[b].cols.size() + j];
+			}
+		}
+		
+		return singularValues.size();
+	}
+	
+	
 	void calculate_svd(Tensor& _U, Tensor& _S, Tensor& _Vt, Tensor _input, const size_t _splitPos, const size_t _maxRank, const value_t _eps) {
 		REQUIRE(0 <= _eps && _eps < 1, "Epsilon must be fullfill 0 <= _eps < 1.");
 		
@@ -1440,8 +1864,11 @@ namespace xerus {
 		
 		std::unique_ptr<value_t[]> tmpS(new value_t[rank]);
 		
-		// Calculate the actual SVD
-		if(_input.is_sparse()) {
+		// Calculate the actual SVD, block by block if the matrix decomposes into independent blocks
+		const std::vector<MatrixBlock> blocks = find_matrix_blocks(_input, lhsSize, rhsSize);
+		if(!blocks.empty()) {
+			rank = blockwise_svd(_U.override_dense_data(), rank, tmpS.get(), _Vt.override_dense_data(), _input, lhsSize, rhsSize, blocks);
+		} else if(_input.is_sparse()) {
 			LOG_ONCE(warning, "Sparse SVD not yet implemented. falling back to the dense SVD");
 			_input.use_dense_representation();
 			blasWrapper::svd(_U.override_dense_data(), tmpS.get(), _Vt.override_dense_data(), _input.get_unsanitized_dense_data(), lhsSize, rhsSize);
@@ -1581,22 +2008,34 @@ namespace xerus {
 			result *= _B.factor;
 			value_t* const dataPtrA = result.get_dense_data();
 			const value_t* const dataPtrB = _B.get_unsanitized_dense_data();
-			for(size_t i = 0; i < result.size; ++i) {
+			const size_t size = result.size;
+			#pragma omp parallel for simd schedule(static) if(size > minParallelSize)
+			for(size_t i = 0; i < size; ++i) {
 				dataPtrA[i] *= dataPtrB[i];
 			}
 			return result;
 		} else if(_A.is_sparse()) {
 			Tensor result(_A);
 			
-			for(std::pair<const size_t, value_t>& entry : result.get_sparse_data()) {
-				entry.second *= _B[entry.first];
+			if(_B.is_dense()) {
+				result *= _B.factor;
+				const value_t* const dataPtrB = _B.get_unsanitized_dense_data();
+				for(std::pair<const size_t, value_t>& entry : result.get_sparse_data()) {
+					entry.second *= dataPtrB[entry.first];
+				}
+			} else {
+				for(std::pair<const size_t, value_t>& entry : result.get_sparse_data()) {
+					entry.second *= _B[entry.first];
+				}
 			}
 			return result;
 		} else { // _B.is_sparse()
 			Tensor result(_B);
 			
+			result *= _A.factor;
+			const value_t* const dataPtrA = _A.get_unsanitized_dense_data();
 			for(std::pair<const size_t, value_t>& entry : result.get_sparse_data()) {
-				entry.second *= _A[entry.first];
+				entry.second *= dataPtrA[entry.first];
 			}
 			return result;
 		}
@@ -1621,6 +2060,17 @@ namespace xerus {
 			for(const auto& entry : _b.get_unsanitized_sparse_data()) {
 				if(!misc::approx_equal(_a[entry.first], _b.factor*entry.second, _eps)) { return false; }
 			}
+		} else if(_a.is_dense() && _b.is_dense()) {
+			const value_t* const dataPtrA = _a.get_unsanitized_dense_data();
+			const value_t* const dataPtrB = _b.get_unsanitized_dense_data();
+			const value_t factorA = _a.factor, factorB = _b.factor;
+			const size_t size = _a.size;
+			bool equal = true;
+			#pragma omp parallel for reduction(&&: equal) schedule(static) if(size > minParallelSize)
+			for(size_t i = 0; i < size; ++i) {
+				equal = equal && misc::approx_equal(factorA*dataPtrA[i], factorB*dataPtrB[i], _eps);
+			}
+			return equal;
 		} else {
 			for(size_t i=0; i < _a.size; ++i) {
 				if(!misc::approx_equal(_a[i], _b[i], _eps)) { return false; }
@@ -1631,6 +2081,17 @@ namespace xerus {
 	
 	bool approx_entrywise_equal(const xerus::Tensor& _tensor, const std::vector<value_t>& _values, const xerus::value_t _eps) {
 		if(_tensor.size != _values.size()) { return false; }
+		if(_tensor.is_dense()) {
+			const value_t* const dataPtr = _tensor.get_unsanitized_dense_data();
+			const value_t factor = _tensor.factor;
+			const size_t size = _tensor.size;
+			bool equal = true;
+			#pragma omp parallel for reduction(&&: equal) schedule(static) if(size > minParallelSize)
+			for(size_t i = 0; i < size; ++i) {
+				equal = equal && misc::approx_equal(factor*dataPtr[i], _values[i], _eps);
+			}
+			return equal;
+		}
 		for(size_t i = 0; i < _tensor.size; ++i) {
 			if(!misc::approx_equal(_tensor[i], _values[i], _eps)) { return false; }
 		}
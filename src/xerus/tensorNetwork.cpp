@@ -30,6 +30,7 @@
 #include <xerus/misc/containerSupport.h>
 #include <xerus/misc/missingFunctions.h>
 #include <xerus/misc/fileIO.h>
+#include <xerus/misc/parallel.h>
 
 #include <xerus/basic.h>
 #include <xerus/index.h>
@@ -41,6 +42,9 @@
 #include <xerus/contractionHeuristic.h>
 
 namespace xerus {
+	double TensorNetwork::minParallelContractionCost = 1e6;
+	size_t TensorNetwork::contractionMemoryBudget = 0;
+	
 	/*- - - - - - - - - - - - - - - - - - - - - - - - - - Constructors - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -*/
 	TensorNetwork::TensorNetwork() {
 		nodes.emplace_back(TensorNode(std::unique_ptr<Tensor>(new Tensor())));
@@ -82,6 +86,8 @@ namespace xerus {
 	
 	std::vector<TensorNetwork::Link> TensorNetwork::init_from_dimension_array() {
 		std::vector<TensorNetwork::Link> newLinks;
+		newLinks.reserve(dimensions.size());
+		externalLinks.reserve(externalLinks.size()+dimensions.size());
 		for (size_t d = 0; d < dimensions.size(); ++d) {
 			externalLinks.emplace_back(0, d, dimensions[d], false);
 			newLinks.emplace_back(-1, d, dimensions[d], true);
@@ -1078,31 +1084,23 @@ namespace xerus {
 	
 	
 	void TensorNetwork::contract(const size_t _nodeId1, const size_t _nodeId2) {
-		TensorNode &node1 = nodes[_nodeId1];
-		TensorNode &node2 = nodes[_nodeId2];
-		
-		REQUIRE(!node1.erased, "It appears node1 = " << _nodeId1 << "  was already contracted?");
-		REQUIRE(!node2.erased, "It appears node2 = " << _nodeId2 << "  was already contracted?");
+		REQUIRE(!nodes[_nodeId1].erased, "It appears node1 = " << _nodeId1 << "  was already contracted?");
+		REQUIRE(!nodes[_nodeId2].erased, "It appears node2 = " << _nodeId2 << "  was already contracted?");
 		REQUIRE(externalLinks.size() == degree(), "Internal Error: " << externalLinks.size() << " != " << degree());
 		
-		std::vector<TensorNetwork::Link> newLinks;
-		newLinks.reserve(node1.degree() + node2.degree());
+		contract_node_tensors(_nodeId1, _nodeId2);
+		relink_contracted_nodes(_nodeId1, _nodeId2);
+		
+		require_valid_network(false);
+	}
+	
+	
+	void TensorNetwork::contract_node_tensors(const size_t _nodeId1, const size_t _nodeId2) {
+		TensorNode &node1 = nodes[_nodeId1];
+		TensorNode &node2 = nodes[_nodeId2];
 		
 		if (!node1.tensorObject) {
 			REQUIRE(!node2.tensorObject, "Internal Error.");
-			
-			// Determine the links of the resulting tensor (first half)
-			for ( const Link& l : node1.neighbors ) {
-				if (!l.links(_nodeId1) && !l.links(_nodeId2)) {
-					newLinks.emplace_back(l);
-				}
-			}
-			// Determine the links of the resulting tensor (second half)
-			for ( const Link& l : node2.neighbors ) {
-				if (!l.links(_nodeId2) && !l.links(_nodeId1)) {
-					newLinks.emplace_back(l);
-				}
-			}
 		} else {
 			REQUIRE(node2.tensorObject, "Internal Error.");
 			
@@ -1114,7 +1112,6 @@ namespace xerus {
 			// first pass of the links of node1 to determine
 			//   1. the number of links between the two nodes,
 			//   2. determine whether node1 is separated (ownlinks-commonlinks) or transposed separated (commonlinks-ownlinks)
-			//   3. determine the links of the resulting tensor (first half)
 			if(node1.degree() > 1) {
 				uint_fast8_t switches = 0;
 				bool previous = node1.neighbors[0].links(_nodeId2);
@@ -1125,12 +1122,9 @@ namespace xerus {
 							switches++;
 							previous = true;
 						}
-					} else {
-						newLinks.emplace_back(l);
-						if (previous) {
-							switches++;
-							previous = false;
-						}
+					} else if (previous) {
+						switches++;
+						previous = false;
 					}
 				}
 				separated1 = (switches < 2);
@@ -1138,8 +1132,6 @@ namespace xerus {
 				if(!node1.neighbors.empty()) {
 					if(node1.neighbors[0].links(_nodeId2)) {
 						contractedDimCount = 1;
-					} else {
-						newLinks.emplace_back(node1.neighbors[0]);
 					}
 				}
 				separated1 = true;
@@ -1149,7 +1141,6 @@ namespace xerus {
 			//   1. whether the order of common links is correct
 			//   2. whether any self-links exist
 			//   3. whether the second node is separated
-			//   4. determine the links of the resulting tensor (second half)
 			if(node2.degree() > 1 && contractedDimCount > 0) {
 				bool previous = node2.neighbors[0].links(_nodeId1);
 				uint_fast8_t switches = 0;
@@ -1165,20 +1156,13 @@ namespace xerus {
 							switches++;
 							previous = true;
 						}
-					} else {
-						newLinks.emplace_back(l);
-						if (previous) {
-							switches++;
-							previous = false;
-						}
+					} else if (previous) {
+						switches++;
+						previous = false;
 					}
 				}
 				separated2 = (switches < 2);
 			} else {
-				if(contractedDimCount == 0) {
-					newLinks.insert(newLinks.end(), node2.neighbors.begin(), node2.neighbors.end());
-				}
-				
 				separated2 = true;
 				matchingOrder = true;
 			}
@@ -1251,6 +1235,25 @@ namespace xerus {
 			
 			xerus::contract(*node1.tensorObject, *node1.tensorObject, trans1, *node2.tensorObject, trans2, contractedDimCount);
 		}
+	}
+	
+	
+	void TensorNetwork::relink_contracted_nodes(const size_t _nodeId1, const size_t _nodeId2) {
+		// The resulting tensor has the remaining links of node1 followed by the remaining links of node2 (in their respective order).
+		// Dataless nodes additionally drop their self-links, for all others those are handled by perform_traces beforehand.
+		const bool dataless = !nodes[_nodeId1].tensorObject;
+		std::vector<TensorNetwork::Link> newLinks;
+		newLinks.reserve(nodes[_nodeId1].degree() + nodes[_nodeId2].degree());
+		for (const Link& l : nodes[_nodeId1].neighbors) {
+			if (!l.links(_nodeId2) && !(dataless && l.links(_nodeId1))) {
+				newLinks.emplace_back(l);
+			}
+		}
+		for (const Link& l : nodes[_nodeId2].neighbors) {
+			if (!l.links(_nodeId1) && !(dataless && l.links(_nodeId2))) {
+				newLinks.emplace_back(l);
+			}
+		}
 		
 		// Set Nodes
 		nodes[_nodeId1].neighbors = std::move(newLinks);
@@ -1267,8 +1270,6 @@ namespace xerus {
 				nodes[l.other].neighbors[l.indexPosition].indexPosition = d;
 			}
 		}
-		
-		require_valid_network(false);
 	}
 
 	
@@ -1302,6 +1303,16 @@ namespace xerus {
 		if (_ids.size() == 0) { return ~0ul; }
 		
 		if (_ids.size() == 1) { return *_ids.begin(); }
+		
+		// With a memory budget the whole contraction is planned up front, as it might have to be sliced.
+		ContractionPlan plan;
+		if (contractionMemoryBudget > 0) {
+			plan = plan_contraction(_ids);
+			LOG(TNContract, "Planned contraction of " << _ids.size() << " nodes in " << plan.numSlices << " slices, expected peak memory " << plan.peakMemory << " bytes.");
+			if (!plan.slicedLinks.empty()) {
+				return contract_sliced(plan);
+			}
+		}
 
 		if (_ids.size() == 2) {
 			auto secItr = _ids.begin(); ++secItr;
@@ -1356,19 +1367,43 @@ namespace xerus {
 		}
 		
 		
-		TensorNetwork strippedNetwork = stripped_subnet([&](size_t _id){ return misc::contains(_ids, _id); }); 
-		double bestCost = std::numeric_limits<double>::max();
-		std::vector<std::pair<size_t, size_t>> bestOrder;
-		
-		// Ask the heuristics
-		for (const internal::ContractionHeuristic &c : internal::contractionHeuristics) {
-			c(bestCost, bestOrder, strippedNetwork);
+		if (plan.order.empty()) {
+			plan = plan_contraction(_ids, 0);
 		}
+		const std::vector<std::pair<size_t, size_t>>& bestOrder = plan.order;
 		
-		REQUIRE(bestCost < std::numeric_limits<double>::max() && !bestOrder.empty(), "Internal Error.");
-		
+		// Group the pairwise contractions into waves of mutually independent steps, i.e. each step only waits for the steps that produced its nodes.
+		std::vector<size_t> readyAfterWave(nodes.size(), 0);
+		std::vector<std::vector<std::pair<size_t, size_t>>> waves;
 		for (const std::pair<size_t,size_t> &c : bestOrder) {
-			contract(c.first, c.second);
+			const size_t wave = std::max(readyAfterWave[c.first], readyAfterWave[c.second]);
+			if (waves.size() <= wave) { waves.resize(wave+1); }
+			waves[wave].push_back(c);
+			readyAfterWave[c.first] = wave+1;
+		}
+		
+		for (const std::vector<std::pair<size_t, size_t>> &wave : waves) {
+			double waveCost = 0.0;
+			if (wave.size() > 1 && misc::get_thread_budget() > 1) {
+				for (const std::pair<size_t,size_t> &c : wave) {
+					waveCost += contraction_cost(c.first, c.second);
+				}
+			}
+			
+			if (wave.size() < 2 || misc::get_thread_budget() < 2 || waveCost < minParallelContractionCost) {
+				for (const std::pair<size_t,size_t> &c : wave) {
+					contract(c.first, c.second);
+				}
+			} else {
+				// The numerical contractions only touch the tensors of their own two nodes and can run concurrently, the links are updated afterwards.
+				misc::parallel_for(wave.size(), [&](const size_t _i){
+					contract_node_tensors(wave[_i].first, wave[_i].second);
+				});
+				for (const std::pair<size_t,size_t> &c : wave) {
+					relink_contracted_nodes(c.first, c.second);
+				}
+				require_valid_network(false);
+			}
 		}
 		
 		// Note: no sanitization as eg. TTStacks require the indices not to change after calling this function
@@ -1376,6 +1411,214 @@ namespace xerus {
 	}
 	
 	
+	/// Returns the maximal number of entries of all nodes of the dataless network @a _network at any point of the contraction @a _order.
+	static double simulated_peak_entries(TensorNetwork _network, const std::vector<std::pair<size_t, size_t>>& _order) {
+		const auto entries = [&](const size_t _id) {
+			double result = 1.0;
+			for (const TensorNetwork::Link& l : _network.nodes[_id].neighbors) {
+				result *= static_cast<double>(l.dimension);
+			}
+			return result;
+		};
+		
+		double current = 0.0;
+		for (size_t id = 0; id < _network.nodes.size(); ++id) {
+			if (!_network.nodes[id].erased) {
+				current += entries(id);
+			}
+		}
+		
+		double peak = current;
+		for (const std::pair<size_t, size_t>& c : _order) {
+			const double inputs = entries(c.first) + entries(c.second);
+			_network.contract(c.first, c.second);
+			const double output = entries(c.first);
+			peak = std::max(peak, current + output);
+			current += output - inputs;
+		}
+		return peak;
+	}
+	
+	
+	/// Sets the dimension of the link at mode @a _mode of node @a _node (at both of its ends) to one, as it is in every slice.
+	static void mark_sliced(TensorNetwork& _network, const size_t _node, const size_t _mode) {
+		TensorNetwork::Link& link = _network.nodes[_node].neighbors[_mode];
+		_network.nodes[link.other].neighbors[link.indexPosition].dimension = 1;
+		link.dimension = 1;
+	}
+	
+	
+	TensorNetwork::ContractionPlan TensorNetwork::plan_contraction(const std::set<size_t>& _ids, const size_t _memoryBudget) const {
+		ContractionPlan plan;
+		TensorNetwork strippedNetwork = stripped_subnet([&](size_t _id){ return misc::contains(_ids, _id); });
+		
+		if (_ids.size() > 1) {
+			// Ask the heuristics
+			double bestCost = std::numeric_limits<double>::max();
+			for (const internal::ContractionHeuristic &c : internal::contractionHeuristics) {
+				c(bestCost, plan.order, strippedNetwork);
+			}
+			REQUIRE(bestCost < std::numeric_limits<double>::max() && !plan.order.empty(), "Internal Error.");
+		}
+		
+		double peak = simulated_peak_entries(strippedNetwork, plan.order);
+		const double budget = static_cast<double>(_memoryBudget)/sizeof(value_t);
+		
+		while (_memoryBudget > 0 && peak > budget) {
+			// Find the internal link whose slicing reduces the peak the most
+			double bestPeak = peak;
+			std::pair<size_t, size_t> bestLink;
+			for (const size_t id : _ids) {
+				for (size_t mode = 0; mode < strippedNetwork.nodes[id].degree(); ++mode) {
+					const Link& link = strippedNetwork.nodes[id].neighbors[mode];
+					if (link.external || link.other <= id || link.dimension == 1) { continue; } // Consider every internal link only once
+					
+					TensorNetwork candidate(strippedNetwork);
+					mark_sliced(candidate, id, mode);
+					const double candidatePeak = simulated_peak_entries(std::move(candidate), plan.order);
+					if (candidatePeak < bestPeak) {
+						bestPeak = candidatePeak;
+						bestLink = std::make_pair(id, mode);
+					}
+				}
+			}
+			
+			if (bestPeak >= peak) {
+				LOG(warning, "Slicing cannot reduce the expected peak memory of " << peak*sizeof(value_t) << " bytes below the budget of " << _memoryBudget << " bytes.");
+				break;
+			}
+			
+			plan.numSlices *= strippedNetwork.nodes[bestLink.first].neighbors[bestLink.second].dimension;
+			plan.slicedLinks.push_back(bestLink);
+			mark_sliced(strippedNetwork, bestLink.first, bestLink.second);
+			peak = bestPeak;
+		}
+		
+		plan.peakMemory = static_cast<size_t>(std::min(peak*sizeof(value_t), static_cast<double>(std::numeric_limits<size_t>::max())));
+		return plan;
+	}
+	
+	
+	size_t TensorNetwork::contract_sliced(const ContractionPlan& _plan) {
+		REQUIRE(!_plan.order.empty() && !_plan.slicedLinks.empty(), "Internal Error.");
+		const size_t resultId = _plan.order.back().first;
+		
+		// Fixes mode _mode of node _node to the slate _position, keeping the mode with dimension one.
+		const auto take_slate = [](TensorNetwork& _network, const size_t _node, const size_t _mode, const size_t _position) {
+			Tensor& tensor = *_network.nodes[_node].tensorObject;
+			Tensor::DimensionTuple sliceDimensions(tensor.dimensions);
+			sliceDimensions[_mode] = 1;
+			tensor.fix_mode(_mode, _position);
+			tensor.reinterpret_dimensions(std::move(sliceDimensions));
+			_network.nodes[_node].neighbors[_mode].dimension = 1;
+		};
+		
+		std::unique_ptr<TensorNetwork> result;
+		misc::parallel_for(_plan.numSlices, [&](const size_t _slice){
+			TensorNetwork slice(*this); // The copy shares the node data
+			size_t remainder = _slice;
+			for (const std::pair<size_t, size_t>& slicedLink : _plan.slicedLinks) {
+				const Link link = slice.nodes[slicedLink.first].neighbors[slicedLink.second];
+				take_slate(slice, slicedLink.first, slicedLink.second, remainder%link.dimension);
+				take_slate(slice, link.other, link.indexPosition, remainder%link.dimension);
+				remainder /= link.dimension;
+			}
+			
+			for (const std::pair<size_t, size_t>& c : _plan.order) {
+				slice.contract(c.first, c.second);
+			}
+			
+			#pragma omp critical(xerus_tensorNetwork_contract_sliced)
+			{
+				if (result) {
+					*result->nodes[resultId].tensorObject += *slice.nodes[resultId].tensorObject;
+				} else {
+					result.reset(new TensorNetwork(std::move(slice)));
+				}
+			}
+		});
+		
+		nodes = std::move(result->nodes);
+		externalLinks = std::move(result->externalLinks);
+		return resultId;
+	}
+	
+	
+	std::vector<Tensor> TensorNetwork::environments() const {
+		REQUIRE(degree() == 0, "Environments are only defined for networks of degree zero, here " << degree());
+		require_valid_network();
+		
+		// Every link between two nodes gets its own index
+		std::vector<std::vector<Index>> nodeIndices(nodes.size());
+		std::set<size_t> ids;
+		for (size_t id = 0; id < nodes.size(); ++id) {
+			if (nodes[id].erased) { continue; }
+			ids.insert(id);
+			nodeIndices[id].resize(nodes[id].degree());
+			for (size_t mode = 0; mode < nodes[id].degree(); ++mode) {
+				const Link& link = nodes[id].neighbors[mode];
+				REQUIRE(!link.links(id), "Environments of nodes with traces are not supported, node " << id << " mode " << mode);
+				if (link.other < id) {
+					nodeIndices[id][mode] = nodeIndices[link.other][link.indexPosition];
+				}
+			}
+		}
+		
+		// The contraction tree: the leaves are the nodes, every pairwise contraction adds a parent of the two current subtrees.
+		// Each subtree is stored as its contracted tensor together with the indices of the links leaving it.
+		std::vector<Tensor> subtrees;
+		std::vector<std::vector<Index>> subtreeIndices;
+		std::vector<std::pair<size_t, size_t>> children;
+		std::vector<size_t> currentSubtree(nodes.size());
+		for (const size_t id : ids) {
+			currentSubtree[id] = subtrees.size();
+			subtrees.push_back(*nodes[id].tensorObject);
+			subtreeIndices.push_back(nodeIndices[id]);
+		}
+		const size_t numLeaves = subtrees.size();
+		
+		// Forward pass, i.e. the usual contraction keeping all intermediates
+		for (const std::pair<size_t, size_t>& c : plan_contraction(ids, 0).order) {
+			const size_t first = currentSubtree[c.first];
+			const size_t second = currentSubtree[c.second];
+			
+			std::vector<Index> openIndices;
+			for (const Index& idx : subtreeIndices[first]) {
+				if (!misc::contains(subtreeIndices[second], idx)) { openIndices.push_back(idx); }
+			}
+			for (const Index& idx : subtreeIndices[second]) {
+				if (!misc::contains(subtreeIndices[first], idx)) { openIndices.push_back(idx); }
+			}
+			
+			Tensor parent;
+			parent(openIndices) = subtrees[first](subtreeIndices[first]) * subtrees[second](subtreeIndices[second]);
+			
+			currentSubtree[c.first] = subtrees.size();
+			subtrees.push_back(std::move(parent));
+			subtreeIndices.push_back(std::move(openIndices));
+			children.emplace_back(first, second);
+		}
+		
+		// Backward pass, the environment of a child is the environment of its parent contracted with its sibling
+		std::vector<Tensor> subtreeEnvironments(subtrees.size());
+		subtreeEnvironments.back() = Tensor::ones({});
+		for (size_t parent = subtrees.size()-1; parent >= numLeaves; --parent) {
+			const size_t first = children[parent-numLeaves].first;
+			const size_t second = children[parent-numLeaves].second;
+			subtreeEnvironments[first](subtreeIndices[first]) = subtreeEnvironments[parent](subtreeIndices[parent]) * subtrees[second](subtreeIndices[second]);
+			subtreeEnvironments[second](subtreeIndices[second]) = subtreeEnvironments[parent](subtreeIndices[parent]) * subtrees[first](subtreeIndices[first]);
+			subtrees[parent].reset(); // Not needed anymore
+		}
+		
+		std::vector<Tensor> result(nodes.size());
+		size_t leaf = 0;
+		for (const size_t id : ids) {
+			result[id] = std::move(subtreeEnvironments[leaf++]);
+		}
+		return result;
+	}
+	
+	
 	value_t TensorNetwork::frob_norm() const {
 		const Index i;
 		Tensor res;
@@ -0,0 +1,261 @@
+// Xerus - A General Purpose Tensor Library
+// Copyright (C) 2014-2016 Benjamin Huber and Sebastian Wolf. 
+// 
+// Xerus is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License,
+// or (at your option) any later version.
+// 
+// Xerus is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Affero General Public License for more details.
+// 
+// You should have received a copy of the GNU Affero General Public License
+// along with Xerus. If not, see <http://www.gnu.org/licenses/>.
+//
+// For further information on Xerus visit https://libXerus.org 
+// or contact us at contact@libXerus.org.
+
+/**
+ * @file
+ * @brief Implementation of the TensorView class and the corresponding contraction and reshuffle.
+ */
+
+#include <xerus/tensorView.h>
+
+#include <xerus/misc/check.h>
+#include <xerus/misc/basicArraySupport.h>
+#include <xerus/misc/math.h>
+
+#include <xerus/tensor.h>
+#include <xerus/blasLapackWrapper.h>
+
+namespace xerus {
+	
+	namespace {
+		/// @brief Copies the entries of @a _in with the given strides into the contiguous row-major array @a _out.
+		void gather(value_t* const _out, const value_t* _in, const std::vector<size_t>& _dimensions, const std::vector<size_t>& _strides) {
+			const size_t degree = _dimensions.size();
+			const size_t size = misc::product(_dimensions);
+			if(degree == 0) { *_out = *_in; return; }
+			
+			const size_t lastDim = _dimensions.back();
+			const size_t lastStride = _strides.back();
+			std::vector<size_t> position(degree-1, 0);
+			for(size_t done = 0; done < size; done += lastDim) {
+				if(lastStride == 1) {
+					misc::copy(_out+done, _in, lastDim);
+				} else {
+					for(size_t k = 0; k < lastDim; ++k) {
+						_out[done+k] = _in[k*lastStride];
+					}
+				}
+				
+				// Advance to the next row
+				for(size_t m = degree-1; m > 0; --m) {
+					if(++position[m-1] < _dimensions[m-1]) {
+						_in += _strides[m-1];
+						break;
+					}
+					_in -= (_dimensions[m-1]-1)*_strides[m-1];
+					position[m-1] = 0;
+				}
+			}
+		}
+		
+		
+		/// @brief Checks whether the modes [_begin, _end) of @a _view can be merged into a single mode and sets @a _stride to the stride of that mode (zero if all modes have dimension one).
+		bool mergeable_modes(const TensorView& _view, const size_t _begin, const size_t _end, size_t& _stride) {
+			_stride = 0;
+			size_t expectedStride = 0;
+			for(size_t i = _end; i > _begin; --i) {
+				if(_view.dimensions[i-1] == 1) { continue; }
+				if(_stride == 0) {
+					_stride = _view.strides[i-1];
+				} else if(_view.strides[i-1] != expectedStride) {
+					return false;
+				}
+				expectedStride = _view.strides[i-1]*_view.dimensions[i-1];
+			}
+			return true;
+		}
+		
+		
+		/// @brief Description of a view as row-major (possibly transposed) BLAS matrix, whose rows are the modes [0, split) and whose columns are the remaining modes.
+		struct BlasMatrix {
+			bool valid;
+			bool transposed;
+			size_t leadingDimension;
+		};
+		
+		BlasMatrix as_blas_matrix(const TensorView& _view, const size_t _split) {
+			size_t rowStride, colStride;
+			if(!mergeable_modes(_view, 0, _split, rowStride) || !mergeable_modes(_view, _split, _view.degree(), colStride)) {
+				return BlasMatrix{false, false, 0};
+			}
+			
+			const size_t rows = misc::product(_view.dimensions, 0, _split);
+			const size_t cols = misc::product(_view.dimensions, _split, _view.degree());
+			
+			if(colStride <= 1 && (rowStride == 0 || rowStride >= cols)) {
+				return BlasMatrix{true, false, rowStride == 0 ? std::max(cols, size_t(1)) : rowStride};
+			}
+			if(rowStride <= 1 && (colStride == 0 || colStride >= rows)) {
+				return BlasMatrix{true, true, colStride == 0 ? std::max(rows, size_t(1)) : colStride};
+			}
+			return BlasMatrix{false, false, 0};
+		}
+		
+		
+		/// @brief Checks whether the data of @a _view lies within the dense data of @a _tensor.
+		bool views_into(const TensorView& _view, const Tensor& _tensor) {
+			if(!_tensor.is_dense() || !_tensor.get_unsanitized_dense_data()) { return false; }
+			const value_t* const begin = _tensor.get_unsanitized_dense_data();
+			return _view.data >= begin && _view.data < begin + _tensor.size;
+		}
+	}
+	
+	
+	TensorView::TensorView(const Tensor& _tensor) : data(_tensor.get_unsanitized_dense_data()), dimensions(_tensor.dimensions), strides(_tensor.degree()), factor(_tensor.factor) {
+		REQUIRE(_tensor.is_dense(), "TensorViews are only available for dense Tensors.");
+		size_t stride = 1;
+		for(size_t i = dimensions.size(); i > 0; --i) {
+			strides[i-1] = stride;
+			stride *= dimensions[i-1];
+		}
+	}
+	
+	
+	size_t TensorView::degree() const {
+		return dimensions.size();
+	}
+	
+	
+	size_t TensorView::size() const {
+		return misc::product(dimensions);
+	}
+	
+	
+	bool TensorView::is_contiguous() const {
+		size_t stride = 1;
+		for(size_t i = dimensions.size(); i > 0; --i) {
+			if(dimensions[i-1] != 1 && strides[i-1] != stride) { return false; }
+			stride *= dimensions[i-1];
+		}
+		return true;
+	}
+	
+	
+	value_t TensorView::operator[](const std::vector<size_t>& _positions) const {
+		REQUIRE(_positions.size() == degree(), "Position " << _positions << " does not fit the dimensions " << dimensions);
+		size_t offset = 0;
+		for(size_t i = 0; i < degree(); ++i) {
+			REQUIRE(_positions[i] < dimensions[i], "Position " << _positions << " does not exist in TensorView of dimensions " << dimensions);
+			offset += _positions[i]*strides[i];
+		}
+		return factor*data[offset];
+	}
+	
+	
+	void TensorView::fix_mode(const size_t _mode, const size_t _slatePosition) {
+		REQUIRE(_mode < degree(), "Invalid mode " << _mode << " for TensorView of degree " << degree());
+		REQUIRE(_slatePosition < dimensions[_mode], "The given slatePosition must be smaller than the corresponding dimension. Here " << _slatePosition << " >= " << dimensions[_mode]);
+		data += _slatePosition*strides[_mode];
+		dimensions.erase(dimensions.begin()+long(_mode));
+		strides.erase(strides.begin()+long(_mode));
+	}
+	
+	
+	void TensorView::restrict_mode(const size_t _mode, const size_t _first, const size_t _newDim) {
+		REQUIRE(_mode < degree(), "Invalid mode " << _mode << " for TensorView of degree " << degree());
+		REQUIRE(_newDim > 0 && _first + _newDim <= dimensions[_mode], "Invalid range [" << _first << ", " << _first+_newDim << ") for mode of dimension " << dimensions[_mode]);
+		data += _first*strides[_mode];
+		dimensions[_mode] = _newDim;
+	}
+	
+	
+	TensorView::operator Tensor() const {
+		Tensor result(dimensions, Tensor::Representation::Dense, Tensor::Initialisation::None);
+		gather(result.override_dense_data(), data, dimensions, strides);
+		result.factor = factor;
+		return result;
+	}
+	
+	
+	void contract(Tensor& _result, const TensorView& _lhs, const bool _lhsTrans, const TensorView& _rhs, const bool _rhsTrans, const size_t _numModes) {
+		REQUIRE(_numModes <= _lhs.degree() && _numModes <= _rhs.degree(), "Cannot contract more indices than both tensors have. we have: " 
+			<< _lhs.degree() << " and " << _rhs.degree() << " but want to contract: " << _numModes);
+		
+		const size_t lhsRemainOrder = _lhs.degree() - _numModes;
+		const size_t rhsRemainOrder = _rhs.degree() - _numModes;
+		const size_t lhsSplit = _lhsTrans ? _numModes : lhsRemainOrder;
+		const size_t rhsSplit = _rhsTrans ? rhsRemainOrder : _numModes;
+		const size_t lhsRemainStart = _lhsTrans ? _numModes : 0;
+		const size_t rhsRemainStart = _rhsTrans ? 0 : _numModes;
+		
+		REQUIRE(std::equal(_lhs.dimensions.begin() + long(_lhsTrans ? 0 : lhsRemainOrder), _lhs.dimensions.begin() + long(_lhsTrans ? _numModes : _lhs.degree()), _rhs.dimensions.begin() + long(_rhsTrans ? rhsRemainOrder : 0)), 
+				"Dimensions of the be contracted indices do not coincide. " <<_lhs.dimensions << " ("<<_lhsTrans<<") and " << _rhs.dimensions << " ("<<_rhsTrans<<") with " << _numModes);
+		
+		// Views that are no strided matrices are copied first
+		Tensor lhsCopy, rhsCopy;
+		TensorView lhs(_lhs), rhs(_rhs);
+		BlasMatrix lhsMatrix = as_blas_matrix(lhs, lhsSplit);
+		if(!lhsMatrix.valid) {
+			lhsCopy = Tensor(_lhs);
+			lhs = TensorView(lhsCopy);
+			lhsMatrix = as_blas_matrix(lhs, lhsSplit);
+		}
+		BlasMatrix rhsMatrix = as_blas_matrix(rhs, rhsSplit);
+		if(!rhsMatrix.valid) {
+			rhsCopy = Tensor(_rhs);
+			rhs = TensorView(rhsCopy);
+			rhsMatrix = as_blas_matrix(rhs, rhsSplit);
+		}
+		
+		Tensor::DimensionTuple resultDim;
+		resultDim.reserve(lhsRemainOrder + rhsRemainOrder);
+		resultDim.insert(resultDim.end(), lhs.dimensions.begin() + long(lhsRemainStart), lhs.dimensions.begin() + long(lhsRemainStart + lhsRemainOrder));
+		resultDim.insert(resultDim.end(), rhs.dimensions.begin() + long(rhsRemainStart), rhs.dimensions.begin() + long(rhsRemainStart + rhsRemainOrder));
+		
+		const size_t leftDim = misc::product(lhs.dimensions, lhsRemainStart, lhsRemainStart + lhsRemainOrder);
+		const size_t midDim = misc::product(lhs.dimensions, _lhsTrans ? 0 : lhsRemainOrder, _lhsTrans ? _numModes : lhs.degree());
+		const size_t rightDim = misc::product(rhs.dimensions, rhsRemainStart, rhsRemainStart + rhsRemainOrder);
+		
+		// Prevent overriding the operands if they are views into _result
+		Tensor tmpResult;
+		Tensor& usedResult = (views_into(lhs, _result) || views_into(rhs, _result)) ? tmpResult : _result;
+		usedResult.reset(std::move(resultDim), Tensor::Representation::Dense, Tensor::Initialisation::None);
+		
+		blasWrapper::matrix_matrix_product(usedResult.override_dense_data(), leftDim, rightDim, lhs.factor*rhs.factor, 
+										lhs.data, lhsMatrix.leadingDimension, _lhsTrans != lhsMatrix.transposed, midDim, 
+										rhs.data, rhsMatrix.leadingDimension, _rhsTrans != rhsMatrix.transposed);
+		
+		if(&usedResult != &_result) {
+			_result = std::move(tmpResult);
+		}
+	}
+	
+	
+	void reshuffle(Tensor& _out, const TensorView& _base, const std::vector<size_t>& _shuffle) {
+		REQUIRE(_shuffle.size() == _base.degree(), "IE");
+		
+		Tensor::DimensionTuple outDimensions(_base.degree());
+		std::vector<size_t> outStrides(_base.degree());
+		for(size_t i = 0; i < _base.degree(); ++i) {
+			REQUIRE(_shuffle[i] < _base.degree(), _shuffle[i] << " is no valid new position!");
+			outDimensions[_shuffle[i]] = _base.dimensions[i];
+			outStrides[_shuffle[i]] = _base.strides[i];
+		}
+		
+		Tensor tmpOut;
+		Tensor& usedOut = views_into(_base, _out) ? tmpOut : _out;
+		usedOut.reset(outDimensions, Tensor::Representation::Dense, Tensor::Initialisation::None);
+		gather(usedOut.override_dense_data(), _base.data, outDimensions, outStrides);
+		usedOut.factor = _base.factor;
+		
+		if(&usedOut != &_out) {
+			_out = std::move(tmpOut);
+		}
+	}
+}
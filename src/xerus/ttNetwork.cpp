@@ -23,22 +23,30 @@
 */
 
 #include <algorithm>
+#include <numeric>
 
 #include <xerus/ttNetwork.h>
 
 #include <xerus/misc/check.h>
 #include <xerus/misc/math.h>
 #include <xerus/misc/performanceAnalysis.h>
+#include <xerus/misc/parallel.h>
 
 #include <xerus/basic.h>
 #include <xerus/misc/basicArraySupport.h>
+#include <xerus/blasLapackWrapper.h>
 #include <xerus/index.h>
 #include <xerus/tensor.h>
+#include <xerus/tensorView.h>
+#include <xerus/measurments.h>
 #include <xerus/ttStack.h>
 #include <xerus/indexedTensorList.h>
 #include <xerus/indexedTensorMoveable.h>
 
 namespace xerus {
+	/// @brief Minimal summed size of the factors for which the dyadic product of several TTNetworks is reduced in parallel.
+	static const size_t minParallelSize = 1ul<<15;
+	
 	/*- - - - - - - - - - - - - - - - - - - - - - - - - - Constructors - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -*/
 	template<bool isOperator>
 	TTNetwork<isOperator>::TTNetwork() : TensorNetwork(), cannonicalized(false) {}
@@ -538,13 +546,35 @@ namespace xerus {
 	TTNetwork<isOperator> TTNetwork<isOperator>::dyadic_product(const std::vector<TTNetwork<isOperator>>& _tensors) {
 		if (_tensors.empty()) { return TTNetwork(); }
 		
-		TTNetwork result(_tensors.back());
-		// construct dyadic products right to left as default cannonicalization is left
-		for (size_t i = _tensors.size()-1; i > 0; --i) {
-			REQUIRE_TEST;
-			result = dyadic_product(_tensors[i-1], result);
+		size_t summedSize = 0;
+		for (const TTNetwork& tensor : _tensors) {
+			summedSize += tensor.datasize();
 		}
-		return result;
+		
+		if (summedSize <= minParallelSize) {
+			TTNetwork result(_tensors.back());
+			// construct dyadic products right to left as default cannonicalization is left
+			for (size_t i = _tensors.size()-1; i > 0; --i) {
+				REQUIRE_TEST;
+				result = dyadic_product(_tensors[i-1], result);
+			}
+			return result;
+		}
+		
+		// Pairwise (tree) reduction, the products of each level are independent of each other. This moves every core 
+		// O(log d) instead of O(1) times and is therefore only used if the factors are large enough to profit from the parallelisation.
+		std::vector<TTNetwork> current(_tensors);
+		while (current.size() > 1) {
+			std::vector<TTNetwork> next((current.size()+1)/2);
+			misc::parallel_for(current.size()/2, [&](const size_t i) {
+				next[i] = dyadic_product(current[2*i], current[2*i+1]);
+			});
+			if (current.size()%2 == 1) {
+				next.back() = std::move(current.back());
+			}
+			current = std::move(next);
+		}
+		return current.front();
 	}
 	
 	
@@ -575,15 +605,16 @@ namespace xerus {
 			(*nodes[0].tensorObject)[0] *= (*nodes[0].tensorObject)[0];
 		} else {
 			
-			#pragma omp for schedule(static)
-			for (size_t i = 0; i < numComponents; ++i) {
+			std::vector<Tensor> newComponents(numComponents);
+			misc::parallel_for(numComponents, [&](const size_t i) {
 				const Tensor& currComp = get_component(i);
 				const size_t leftRank = currComp.dimensions.front();
 				const size_t rightRank = currComp.dimensions.back();
 				
-				Tensor newComponent(isOperator ? 
-					  std::vector<size_t>({misc::sqr(leftRank), currComp.dimensions[1], currComp.dimensions[2], misc::sqr(rightRank)})
-					: std::vector<size_t>({misc::sqr(leftRank),  currComp.dimensions[1], misc::sqr(rightRank)}),
+				Tensor& newComponent = newComponents[i];
+				newComponent.reset(isOperator ? 
+					  Tensor::DimensionTuple({misc::sqr(leftRank), currComp.dimensions[1], currComp.dimensions[2], misc::sqr(rightRank)})
+					: Tensor::DimensionTuple({misc::sqr(leftRank),  currComp.dimensions[1], misc::sqr(rightRank)}),
 					currComp.representation, Tensor::Initialisation::None );
 				
 				const size_t externalDim = isOperator ? currComp.dimensions[1] * currComp.dimensions[2] : currComp.dimensions[1];
@@ -611,11 +642,10 @@ namespace xerus {
 						}
 					}
 				}
-				
-				#pragma omp critical
-				{
-					set_component(i, std::move(newComponent));
-				}
+			});
+			
+			for (size_t i = 0; i < numComponents; ++i) {
+				set_component(i, std::move(newComponents[i]));
 			}
 		}
 		
@@ -845,6 +875,38 @@ namespace xerus {
 	}
 	
 	
+	template<bool isOperator>
+	void TTNetwork<isOperator>::reserve_ranks(const std::vector<size_t>& _maxRanks) {
+		REQUIRE(_maxRanks.size() == num_ranks(), "Wrong number of ranks given to reserve_ranks: " << _maxRanks.size() << " vs " << num_ranks());
+		const size_t numComponents = degree()/N;
+		
+		for (size_t i = 0; i < numComponents; ++i) {
+			Tensor& comp = component(i);
+			const size_t leftRank = i == 0 ? 1 : std::max(comp.dimensions.front(), _maxRanks[i-1]);
+			const size_t rightRank = i+1 == numComponents ? 1 : std::max(comp.dimensions.back(), _maxRanks[i]);
+			comp.reserve(leftRank*misc::product(comp.dimensions, 1, N+1)*rightRank);
+		}
+	}
+	
+	
+	template<bool isOperator>
+	void TTNetwork<isOperator>::grow_ranks(const std::vector<size_t>& _newRanks) {
+		REQUIRE(_newRanks.size() == num_ranks(), "Wrong number of ranks given to grow_ranks: " << _newRanks.size() << " vs " << num_ranks());
+		
+		for (size_t i = 0; i < _newRanks.size(); ++i) {
+			const size_t oldRank = rank(i);
+			REQUIRE(_newRanks[i] >= oldRank, "grow_ranks cannot reduce rank " << i << " from " << oldRank << " to " << _newRanks[i] << ", use round() instead.");
+			if(_newRanks[i] == oldRank) { continue; }
+			
+			component(i).resize_mode(N+1, _newRanks[i]);
+			component(i+1).resize_mode(0, _newRanks[i]);
+			nodes[i+1].neighbors.back().dimension = _newRanks[i];
+			nodes[i+2].neighbors.front().dimension = _newRanks[i];
+			cannonicalized = false;
+		}
+	}
+	
+	
 	template<bool isOperator>
 	void TTNetwork<isOperator>::assume_core_position(const size_t _pos) {
 		REQUIRE(_pos < degree()/N || (degree() == 0 && _pos == 0), "Invalid core position.");
@@ -898,8 +960,58 @@ namespace xerus {
 		if (cannonicalized) {
 			return get_component(corePosition).frob_norm();
 		} else {
-			const Index i;
-			return std::sqrt(value_t((*this)(i&0)*(*this)(i&0)));
+			return std::sqrt(dot(*this, *this));
+		}
+	}
+	
+	
+	template<bool isOperator>
+	void TTNetwork<isOperator>::measure(SinglePointMeasurementSet& _measurments) const {
+		require_correct_format();
+		const size_t numComponents = degree()/N;
+		
+		for(size_t i = 0; i < numComponents; ++i) {
+			if(!get_component(i).is_dense()) {
+				TensorNetwork::measure(_measurments);
+				return;
+			}
+		}
+		if(numComponents == 0 || _measurments.size() == 0) {
+			TensorNetwork::measure(_measurments);
+			return;
+		}
+		
+		// Sort measurements
+		sort(_measurments, degree()-1);
+		
+		// stack[i] is the product of the slices of the first i components at the current position
+		std::vector<Tensor> stack(numComponents+1);
+		stack[0] = Tensor::ones({1});
+		
+		for(size_t j = 0; j < _measurments.size(); ++j) {
+			const std::vector<size_t>& position = _measurments.positions[j];
+			
+			// Find the maximal recyclable stack position
+			size_t rebuildIndex = 0;
+			if(j > 0) {
+				const std::vector<size_t>& lastPosition = _measurments.positions[j-1];
+				while(rebuildIndex < numComponents && lastPosition[rebuildIndex] == position[rebuildIndex]
+					&& (!isOperator || lastPosition[numComponents+rebuildIndex] == position[numComponents+rebuildIndex])) {
+					++rebuildIndex;
+				}
+			}
+			
+			// Rebuild stack
+			for(size_t i = rebuildIndex; i < numComponents; ++i) {
+				TensorView slice(get_component(i));
+				if(isOperator) {
+					slice.fix_mode(2, position[numComponents+i]);
+				}
+				slice.fix_mode(1, position[i]);
+				xerus::contract(stack[i+1], TensorView(stack[i]), false, slice, false, 1);
+			}
+			
+			_measurments.measuredValues[j] = stack.back()[0];
 		}
 	}
 	
@@ -919,7 +1031,8 @@ namespace xerus {
 			
 			X = *this;
 			while(misc::sum(X.ranks()) >= degree()) {
-				X.entrywise_square();
+				// Singular values below tau are removed by the soft thresholding anyway, so the square only has to be formed up to a fraction of tau.
+				X = entrywise_product_and_round(X, X, std::numeric_limits<size_t>::max(), tau/(10.0*misc::sqr(X.frob_norm())));
 				
 				X.soft_threshold(tau, true);
 				
@@ -958,6 +1071,76 @@ namespace xerus {
 	}
 	
 	
+	template<bool isOperator>
+	std::vector<std::pair<size_t, value_t>> TTNetwork<isOperator>::find_largest_entries(const size_t _k, const size_t _beamWidth) const {
+		require_correct_format();
+		REQUIRE(_k > 0, "At least one entry has to be requested.");
+		
+		if(degree() == 0) {
+			return std::vector<std::pair<size_t, value_t>>(1, std::make_pair(size_t(0), (*nodes[0].tensorObject)[0]));
+		}
+		
+		const size_t numComponents = degree()/N;
+		const size_t beamWidth = std::max(_k, _beamWidth);
+		
+		// With all components but the first right-orthogonal, the norm of a left interface equals the norm of the corresponding slice of the tensor
+		TTNetwork X(*this);
+		X.cannonicalize_left();
+		
+		std::vector<size_t> strides(degree(), 1);
+		for(size_t i = degree()-1; i > 0; --i) {
+			strides[i-1] = strides[i]*dimensions[i];
+		}
+		
+		// The beam of partial positions and their left interfaces, stored as a beamSize x leftRank matrix
+		std::vector<size_t> positions(1, 0), newPositions;
+		std::vector<value_t> interfaces(1, 1.0), newInterfaces, candidates, norms;
+		std::vector<size_t> order;
+		size_t leftRank = 1;
+		
+		for(size_t c = 0; c < numComponents; ++c) {
+			Tensor comp = X.get_component(c);
+			const size_t localSize = isOperator ? dimensions[c]*dimensions[numComponents+c] : dimensions[c];
+			const size_t rightRank = comp.dimensions.back();
+			const size_t numCandidates = positions.size()*localSize;
+			
+			candidates.resize(numCandidates*rightRank);
+			blasWrapper::matrix_matrix_product(candidates.data(), positions.size(), localSize*rightRank, 1.0, interfaces.data(), false, leftRank, comp.get_dense_data(), false);
+			
+			norms.resize(numCandidates);
+			for(size_t i = 0; i < numCandidates; ++i) {
+				norms[i] = blasWrapper::two_norm(candidates.data() + i*rightRank, rightRank);
+			}
+			
+			const size_t keep = std::min(numCandidates, c+1 < numComponents ? beamWidth : _k);
+			order.resize(numCandidates);
+			std::iota(order.begin(), order.end(), 0);
+			std::partial_sort(order.begin(), order.begin()+long(keep), order.end(), [&](const size_t _a, const size_t _b){ return norms[_a] > norms[_b]; });
+			
+			newPositions.resize(keep);
+			newInterfaces.resize(keep*rightRank);
+			for(size_t i = 0; i < keep; ++i) {
+				const size_t b = order[i]/localSize;
+				const size_t l = order[i]%localSize;
+				const size_t offset = isOperator ? (l/dimensions[numComponents+c])*strides[c] + (l%dimensions[numComponents+c])*strides[numComponents+c] : l*strides[c];
+				newPositions[i] = positions[b] + offset;
+				misc::copy(newInterfaces.data() + i*rightRank, candidates.data() + order[i]*rightRank, rightRank);
+			}
+			
+			std::swap(positions, newPositions);
+			std::swap(interfaces, newInterfaces);
+			leftRank = rightRank;
+		}
+		
+		std::vector<std::pair<size_t, value_t>> result;
+		result.reserve(positions.size());
+		for(size_t i = 0; i < positions.size(); ++i) {
+			result.emplace_back(positions[i], interfaces[i]);
+		}
+		return result;
+	}
+	
+	
 	
 	/*- - - - - - - - - - - - - - - - - - - - - - - - - -  Basic arithmetics - - - - - - - - - - - - - - - - - - - - - - - - - - */
 	
@@ -977,7 +1160,8 @@ namespace xerus {
 		}
 		
 		PA_START;
-		for(size_t position = 0; position < numComponents; ++position) {
+		std::vector<Tensor> newComponents(numComponents);
+		misc::parallel_for(numComponents, [&](const size_t position) {
 			// Get current components
 			const Tensor& myComponent = get_component(position);
 			const Tensor& otherComponent = _other.get_component(position);
@@ -994,16 +1178,19 @@ namespace xerus {
 			nxtDimensions.emplace_back(position == numComponents-1 ? 1 : myComponent.dimensions.back()+otherComponent.dimensions.back());
 			
 			const Tensor::Representation newRep = myComponent.is_sparse() || otherComponent.is_sparse() ? Tensor::Representation::Sparse : Tensor::Representation::Dense;
-			std::unique_ptr<Tensor> newComponent(new Tensor(std::move(nxtDimensions), newRep));
+			Tensor& newComponent = newComponents[position];
+			newComponent.reset(std::move(nxtDimensions), newRep);
 			
-			newComponent->offset_add(myComponent, isOperator ? std::vector<size_t>({0,0,0,0}) : std::vector<size_t>({0,0,0}));
+			newComponent.offset_add(myComponent, isOperator ? std::vector<size_t>({0,0,0,0}) : std::vector<size_t>({0,0,0}));
 			
 			const size_t leftOffset = position == 0 ? 0 : myComponent.dimensions.front();
 			const size_t rightOffset = position == numComponents-1 ? 0 : myComponent.dimensions.back();
 			
-			newComponent->offset_add(otherComponent, isOperator ? std::vector<size_t>({leftOffset,0,0,rightOffset}) : std::vector<size_t>({leftOffset,0,rightOffset}));
-			
-			set_component(position, std::move(*newComponent));
+			newComponent.offset_add(otherComponent, isOperator ? std::vector<size_t>({leftOffset,0,0,rightOffset}) : std::vector<size_t>({leftOffset,0,rightOffset}));
+		});
+		
+		for(size_t position = 0; position < numComponents; ++position) {
+			set_component(position, std::move(newComponents[position]));
 		}
 		PA_END("ADD/SUB", "TTNetwork ADD/SUB", std::string("Dims:")+misc::to_string(dimensions)+" Ranks: "+misc::to_string(ranks()));
 		
@@ -1451,21 +1638,20 @@ namespace xerus {
 		TTNetwork<isOperator> result(_A.degree());
 		const size_t numComponents = _A.degree() / N;
 		
-		#pragma omp for schedule(static)
-		for (size_t i = 0; i < numComponents; ++i) {
+		std::vector<Tensor> newComponents(numComponents);
+		misc::parallel_for(numComponents, [&](const size_t i) {
 			const Tensor& componentA = _A.get_component(i);
 			const Tensor& componentB = _B.get_component(i);
 			const Tensor::Representation newRep = componentA.is_sparse() && componentB.is_sparse() ? Tensor::Representation::Sparse : Tensor::Representation::Dense;
-			Tensor newComponent(isOperator ? 
+			newComponents[i].reset(isOperator ? 
 				Tensor::DimensionTuple({componentA.dimensions.front()*componentB.dimensions.front(), componentA.dimensions[1], componentA.dimensions[2], componentA.dimensions.back()*componentB.dimensions.back()}) : 
 				Tensor::DimensionTuple({componentA.dimensions.front()*componentB.dimensions.front(), componentA.dimensions[1], componentA.dimensions.back()*componentB.dimensions.back()}), newRep);
 			
-			perform_component_product<isOperator>(newComponent, componentA, componentB);
-			
-			#pragma omp critical
-			{
-				result.set_component(i, std::move(newComponent));
-			}
+			perform_component_product<isOperator>(newComponents[i], componentA, componentB);
+		});
+		
+		for (size_t i = 0; i < numComponents; ++i) {
+			result.set_component(i, std::move(newComponents[i]));
 		}
 		
 		if (_A.cannonicalized && _B.cannonicalized) {
@@ -1479,6 +1665,269 @@ namespace xerus {
 	template TTNetwork<false> entrywise_product(const TTNetwork<false> &_A, const TTNetwork<false> &_B);
 	template TTNetwork<true> entrywise_product(const TTNetwork<true> &_A, const TTNetwork<true> &_B);
 	
+	
+	template<bool isOperator>
+	TTNetwork<isOperator> entrywise_product_and_round(TTNetwork<isOperator> _A, TTNetwork<isOperator> _B, const std::vector<size_t>& _maxRanks, const double _eps) {
+		static constexpr const size_t N = isOperator?2:1;
+		const size_t numComponents = _A.degree()/N;
+		REQUIRE(_A.dimensions == _B.dimensions, "Entrywise_product ill-defined for different external dimensions.");
+		REQUIRE(_maxRanks.size()+1 == numComponents || (_maxRanks.empty() && numComponents == 0), "There must be exactly degree/N-1 maxRanks. Here " << _maxRanks.size() << " instead of " << numComponents-1 << " are given.");
+		
+		// If the zip-up would neither truncate ranks nor singular values, forming the product and rounding it is cheaper
+		const std::vector<size_t> ranksA = _A.ranks(), ranksB = _B.ranks();
+		bool truncates = _eps > EPSILON;
+		for (size_t k = 0; k < _maxRanks.size(); ++k) {
+			truncates = truncates || _maxRanks[k] < ranksA[k]*ranksB[k]/2;
+		}
+		if (!truncates || numComponents <= 1) {
+			TTNetwork<isOperator> result = entrywise_product(_A, _B);
+			if (numComponents > 1) {
+				result.round(_maxRanks, _eps);
+			}
+			return result;
+		}
+		
+		// As in apply_and_round() both factors are right-orthogonal, so each zip-up truncation neglects singular values of the product with a remainder of norm at most one
+		_A.cannonicalize_left();
+		_B.cannonicalize_left();
+		
+		const Index r1, r2, s, a1, a2, b1, b2, n;
+		TTNetwork<isOperator> result(_A.dimensions);
+		Tensor carry = Tensor::ones({1,1,1});
+		Tensor partial, next, U, S, Vt;
+		for (size_t k = 0; k < numComponents; ++k) {
+			Tensor componentA = _A.get_component(k);
+			Tensor componentB = _B.get_component(k);
+			const size_t externalDim = isOperator ? componentA.dimensions[1]*componentA.dimensions[2] : componentA.dimensions[1];
+			const size_t rankA = componentA.dimensions.back(), rankB = componentB.dimensions.back(), leftRankB = componentB.dimensions.front();
+			componentA.reinterpret_dimensions({componentA.dimensions.front(), externalDim, rankA});
+			componentB.use_dense_representation();
+			
+			// The external index is shared by both factors, so it cannot be expressed as a single contraction. Contract with A first and multiply the slices of B by hand.
+			partial(r1, b1, n, a2) = carry(r1, a1, b1) * componentA(a1, n, a2);
+			const size_t leftRank = partial.dimensions[0];
+			next.reset({leftRank, externalDim, rankA, rankB}, Tensor::Representation::Dense);
+			const value_t* const partialData = partial.get_dense_data();
+			const value_t* const compBData = componentB.get_dense_data();
+			value_t* const nextData = next.get_dense_data();
+			for (size_t r = 0; r < leftRank; ++r) {
+				for (size_t b = 0; b < leftRankB; ++b) {
+					for (size_t i = 0; i < externalDim; ++i) {
+						for (size_t a = 0; a < rankA; ++a) {
+							misc::add_scaled(nextData + ((r*externalDim + i)*rankA + a)*rankB, partialData[((r*leftRankB + b)*externalDim + i)*rankA + a], compBData + (b*externalDim + i)*rankB, rankB);
+						}
+					}
+				}
+			}
+			
+			if (k+1 < numComponents) {
+				const size_t zipRank = _maxRanks[k] > std::numeric_limits<size_t>::max()/2 ? _maxRanks[k] : 2*_maxRanks[k];
+				(U(r1, n, s), S(s, r2), Vt(r2, a2, b2)) = SVD(next(r1, n, a2, b2), zipRank, _eps/10);
+				carry(s, a2, b2) = S(s, r2) * Vt(r2, a2, b2);
+				if (isOperator) {
+					U.reinterpret_dimensions({U.dimensions[0], _A.dimensions[k], _A.dimensions[numComponents+k], U.dimensions[2]});
+				}
+				result.set_component(k, std::move(U));
+			} else {
+				next.reinterpret_dimensions(isOperator ? 
+					Tensor::DimensionTuple({leftRank, _A.dimensions[k], _A.dimensions[numComponents+k], 1}) :
+					Tensor::DimensionTuple({leftRank, _A.dimensions[k], 1}));
+				result.set_component(k, std::move(next));
+			}
+		}
+		
+		result.assume_core_position(numComponents-1);
+		result.round(_maxRanks, _eps);
+		return result;
+	}
+	
+	template TTNetwork<false> entrywise_product_and_round(TTNetwork<false> _A, TTNetwork<false> _B, const std::vector<size_t>& _maxRanks, const double _eps);
+	template TTNetwork<true> entrywise_product_and_round(TTNetwork<true> _A, TTNetwork<true> _B, const std::vector<size_t>& _maxRanks, const double _eps);
+	
+	
+	template<bool isOperator>
+	TTNetwork<isOperator> entrywise_product_and_round(TTNetwork<isOperator> _A, TTNetwork<isOperator> _B, const size_t _maxRank, const double _eps) {
+		const size_t numComponents = _A.degree()/(isOperator?2:1);
+		const std::vector<size_t> maxRanks(numComponents > 0 ? numComponents-1 : 0, _maxRank);
+		return entrywise_product_and_round(std::move(_A), std::move(_B), maxRanks, _eps);
+	}
+	
+	template TTNetwork<false> entrywise_product_and_round(TTNetwork<false> _A, TTNetwork<false> _B, const size_t _maxRank, const double _eps);
+	template TTNetwork<true> entrywise_product_and_round(TTNetwork<true> _A, TTNetwork<true> _B, const size_t _maxRank, const double _eps);
+	
+	
+	TTTensor apply_and_round(const TTOperator& _A, TTTensor _x, const std::vector<size_t>& _maxRanks, const double _eps) {
+		const size_t numComponents = _x.degree();
+		REQUIRE(_A.degree() == 2*numComponents, "Operator of degree " << _A.degree() << " cannot be applied to a tensor of degree " << numComponents);
+		REQUIRE(std::equal(_x.dimensions.begin(), _x.dimensions.end(), _A.dimensions.begin()+long(numComponents)), "Dimensions mismatch: " << _A.dimensions << " vs " << _x.dimensions);
+		REQUIRE(_maxRanks.size()+1 == numComponents || (_maxRanks.empty() && numComponents == 0), "There must be exactly degree-1 maxRanks. Here " << _maxRanks.size() << " instead of " << numComponents-1 << " are given.");
+		
+		const Index r1, r2, s, a1, a2, x1, x2, n, m;
+		TTTensor result;
+		
+		// If the zip-up would not truncate anything, forming the product and rounding it is cheaper
+		const std::vector<size_t> ranksA = _A.ranks(), ranksX = _x.ranks();
+		bool truncates = false;
+		for (size_t k = 0; k < _maxRanks.size(); ++k) {
+			truncates = truncates || _maxRanks[k] < ranksA[k]*ranksX[k]/2;
+		}
+		if (!truncates) {
+			result(n&0) = _A(n/2, m/2) * _x(m&0);
+			if (numComponents > 1) {
+				result.round(_maxRanks, _eps);
+			}
+			return result;
+		}
+		
+		// With x right-orthogonal the zip-up truncation at each position only neglects singular values of the product with an orthogonal remainder of x
+		_x.cannonicalize_left();
+		
+		result = TTTensor(Tensor::DimensionTuple(_A.dimensions.begin(), _A.dimensions.begin()+long(numComponents)));
+		Tensor carry = Tensor::ones({1,1,1});
+		Tensor next, U, S, Vt;
+		for (size_t k = 0; k < numComponents; ++k) {
+			next(r1, n, a2, x2) = carry(r1, a1, x1) * _A.get_component(k)(a1, n, m, a2) * _x.get_component(k)(x1, m, x2);
+			
+			if (k+1 < numComponents) {
+				const size_t zipRank = _maxRanks[k] > std::numeric_limits<size_t>::max()/2 ? _maxRanks[k] : 2*_maxRanks[k];
+				(U(r1, n, s), S(s, r2), Vt(r2, a2, x2)) = SVD(next(r1, n, a2, x2), zipRank, _eps/10);
+				carry(s, a2, x2) = S(s, r2) * Vt(r2, a2, x2);
+				result.set_component(k, std::move(U));
+			} else {
+				next.reinterpret_dimensions({next.dimensions[0], next.dimensions[1], 1});
+				result.set_component(k, std::move(next));
+			}
+		}
+		
+		result.assume_core_position(numComponents-1);
+		result.round(_maxRanks, _eps);
+		return result;
+	}
+	
+	
+	TTTensor apply_and_round(const TTOperator& _A, TTTensor _x, const size_t _maxRank, const double _eps) {
+		const std::vector<size_t> maxRanks(_x.degree() > 0 ? _x.degree()-1 : 0, _maxRank);
+		return apply_and_round(_A, std::move(_x), maxRanks, _eps);
+	}
+	
+	
+	/// @brief Returns a pointer to dense data of the component, using @a _buffer if it is sparse. The factor of the component is not applied.
+	static const value_t* dense_component_data(const Tensor& _component, Tensor& _buffer) {
+		if(_component.is_dense()) {
+			return _component.get_unsanitized_dense_data();
+		}
+		_buffer = _component;
+		_buffer.factor = 1.0;
+		return _buffer.get_dense_data();
+	}
+	
+	
+	template<bool isOperator>
+	value_t dot(const TTNetwork<isOperator>& _A, const TTNetwork<isOperator>& _B) {
+		REQUIRE(_A.dimensions == _B.dimensions, "Dot product ill-defined for different external dimensions: " << _A.dimensions << " vs " << _B.dimensions);
+		_A.require_correct_format();
+		_B.require_correct_format();
+		
+		if(_A.degree() == 0) {
+			return _A[0]*_B[0];
+		}
+		
+		const size_t numComponents = _A.degree()/(isOperator?2:1);
+		value_t factor = 1.0;
+		std::vector<value_t> left(1, 1.0), tmp;
+		Tensor bufferA, bufferB;
+		for(size_t k = 0; k < numComponents; ++k) {
+			const Tensor& compA = _A.get_component(k);
+			const Tensor& compB = _B.get_component(k);
+			const size_t externalDim = compA.size/(compA.dimensions.front()*compA.dimensions.back());
+			const size_t rankA1 = compA.dimensions.front(), rankA2 = compA.dimensions.back();
+			const size_t rankB1 = compB.dimensions.front(), rankB2 = compB.dimensions.back();
+			factor *= compA.factor*compB.factor;
+			
+			// tmp(b1, n, a2) = left(a1, b1) * A(a1, n, a2), then left(a2, b2) = tmp(b1, n, a2) * B(b1, n, b2)
+			tmp.resize(rankB1*externalDim*rankA2);
+			blasWrapper::matrix_matrix_product(tmp.data(), rankB1, externalDim*rankA2, 1.0, left.data(), true, rankA1, dense_component_data(compA, bufferA), false);
+			left.resize(rankA2*rankB2);
+			blasWrapper::matrix_matrix_product(left.data(), rankA2, rankB2, 1.0, tmp.data(), true, rankB1*externalDim, dense_component_data(compB, bufferB), false);
+		}
+		return factor*left[0];
+	}
+	
+	template value_t dot(const TTNetwork<false>& _A, const TTNetwork<false>& _B);
+	template value_t dot(const TTNetwork<true>& _A, const TTNetwork<true>& _B);
+	
+	
+	template<bool isOperator>
+	Tensor gram_matrix(const std::vector<TTNetwork<isOperator>>& _tensors) {
+		REQUIRE(!_tensors.empty(), "Gram matrix of no tensors requested.");
+		const size_t m = _tensors.size();
+		Tensor result({m, m});
+		
+		const size_t numComponents = _tensors.front().degree()/(isOperator?2:1);
+		for(const TTNetwork<isOperator>& tensor : _tensors) {
+			REQUIRE(tensor.dimensions == _tensors.front().dimensions, "Gram matrix ill-defined for different external dimensions: " << tensor.dimensions << " vs " << _tensors.front().dimensions);
+			tensor.require_correct_format();
+		}
+		
+		if(numComponents == 0) {
+			for(size_t i = 0; i < m; ++i) {
+				for(size_t j = 0; j < m; ++j) {
+					result[{i, j}] = _tensors[i][0]*_tensors[j][0];
+				}
+			}
+			return result;
+		}
+		
+		value_t* const resultData = result.get_dense_data();
+		
+		// For each i the transposed interfaces left(b_j, a) of all j >= i are stacked, so the contraction with the components of x_i is a single GEMM per site.
+		misc::parallel_for(m, [&](const size_t i) {
+			const size_t numPartners = m-i;
+			std::vector<size_t> offsets(numPartners+1), newOffsets(numPartners+1, 0);
+			std::iota(offsets.begin(), offsets.end(), 0);
+			std::vector<value_t> left(numPartners, 1.0), tmp, newLeft;
+			std::vector<value_t> factors(numPartners, 1.0);
+			Tensor bufferA, bufferB;
+			size_t rankA1 = 1;
+			
+			for(size_t k = 0; k < numComponents; ++k) {
+				const Tensor& compA = _tensors[i].get_component(k);
+				const size_t externalDim = compA.size/(compA.dimensions.front()*compA.dimensions.back());
+				const size_t rankA2 = compA.dimensions.back();
+				
+				// tmp(b_j, n, a2) = left(b_j, a1) * A(a1, n, a2) for all j at once
+				tmp.resize(offsets.back()*externalDim*rankA2);
+				blasWrapper::matrix_matrix_product(tmp.data(), offsets.back(), externalDim*rankA2, compA.factor, left.data(), false, rankA1, dense_component_data(compA, bufferA), false);
+				
+				// newLeft(b2_j, a2) = B_j(b_j, n, b2_j) * tmp(b_j, n, a2)
+				for(size_t j = 0; j < numPartners; ++j) {
+					newOffsets[j+1] = newOffsets[j] + _tensors[i+j].get_component(k).dimensions.back();
+				}
+				newLeft.resize(newOffsets.back()*rankA2);
+				for(size_t j = 0; j < numPartners; ++j) {
+					const Tensor& compB = _tensors[i+j].get_component(k);
+					factors[j] *= compB.factor;
+					blasWrapper::matrix_matrix_product(newLeft.data()+newOffsets[j]*rankA2, newOffsets[j+1]-newOffsets[j], rankA2, 1.0, dense_component_data(compB, bufferB), true, 
+						(offsets[j+1]-offsets[j])*externalDim, tmp.data()+offsets[j]*externalDim*rankA2, false);
+				}
+				
+				std::swap(left, newLeft);
+				std::swap(offsets, newOffsets);
+				rankA1 = rankA2;
+			}
+			
+			for(size_t j = 0; j < numPartners; ++j) {
+				resultData[i*m+i+j] = factors[j]*left[j];
+				resultData[(i+j)*m+i] = factors[j]*left[j];
+			}
+		});
+		
+		return result;
+	}
+	
+	template Tensor gram_matrix(const std::vector<TTNetwork<false>>& _tensors);
+	template Tensor gram_matrix(const std::vector<TTNetwork<true>>& _tensors);
+	
 	namespace misc {
 		
 		template<bool isOperator>
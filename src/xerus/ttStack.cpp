@@ -29,6 +29,7 @@
 #include <xerus/index.h>
 #include <xerus/tensor.h>
 #include <xerus/ttNetwork.h>
+#include <xerus/misc/parallel.h>
  
 
 namespace xerus {
@@ -95,11 +96,14 @@ namespace xerus {
 			nodes[0].neighbors.front().other = 1;
 			nodes[0].neighbors.front().indexPosition = 0;
 
-			// Fix all real components
-			std::vector<size_t> shuffle(N+2*stackSize);
+			// Fix all real components. First determine the reshuffles from the (still unmodified) neighbor structure...
+			std::vector<std::vector<size_t>> shuffles(numComponents, std::vector<size_t>(N+2*stackSize));
+			std::vector<size_t> leftDims(numComponents, 1), rightDims(numComponents, 1);
 			for (size_t i = 1; i+1 < numNodes; ++i) {
+				std::vector<size_t>& shuffle = shuffles[i-1];
+				size_t& leftDim = leftDims[i-1];
+				size_t& rightDim = rightDims[i-1];
 				size_t leftCount = 0;
-				size_t leftDim = 1, rightDim = 1;
 				size_t fullDim = 1;
 				for(size_t k = 0; k < N+2*stackSize; ++k) {
 					REQUIRE(!nodes[i].erased, "IE");
@@ -135,14 +139,23 @@ namespace xerus {
 				}
 				REQUIRE(fullDim == nodes[i].tensorObject->size, "Uhh");
 				REQUIRE(leftCount == stackSize, "IE");
-				
-				xerus::reshuffle(*nodes[i].tensorObject, *nodes[i].tensorObject, shuffle);
+			}
+			
+			// ...then reshuffle the components, which are independent of each other...
+			misc::parallel_for(numComponents, [&](const size_t _c) {
+				const size_t i = _c+1;
+				xerus::reshuffle(*nodes[i].tensorObject, *nodes[i].tensorObject, shuffles[_c]);
 				if(isOperator) {
-					nodes[i].tensorObject->reinterpret_dimensions({leftDim, dimensions[i-1], dimensions[i-1+numComponents], rightDim});
+					nodes[i].tensorObject->reinterpret_dimensions({leftDims[_c], dimensions[i-1], dimensions[i-1+numComponents], rightDims[_c]});
 				} else {
-					nodes[i].tensorObject->reinterpret_dimensions({leftDim, dimensions[i-1], rightDim});
+					nodes[i].tensorObject->reinterpret_dimensions({leftDims[_c], dimensions[i-1], rightDims[_c]});
 				}
-				
+			});
+			
+			// ...and finally set the new neighbors.
+			for (size_t i = 1; i+1 < numNodes; ++i) {
+				const size_t leftDim = leftDims[i-1];
+				const size_t rightDim = rightDims[i-1];
 				nodes[i].neighbors.clear();
 				nodes[i].neighbors.emplace_back(i-1, i==1 ? 0 : N+1, leftDim, false);
 				nodes[i].neighbors.emplace_back(0, i-1 , dimensions[i-1], true);
@@ -245,11 +258,14 @@ namespace xerus {
 			_me.tensorObject->nodes[0].neighbors.front().other = 1;
 			_me.tensorObject->nodes[0].neighbors.front().indexPosition = 0;
 
-			// Fix all real components
-			std::vector<size_t> shuffle(N+2*stackSize);
+			// Fix all real components. First determine the reshuffles from the (still unmodified) neighbor structure...
+			std::vector<std::vector<size_t>> shuffles(numComponents, std::vector<size_t>(N+2*stackSize));
+			std::vector<size_t> leftDims(numComponents, 1), rightDims(numComponents, 1);
 			for (size_t i = 1; i+1 < numNodes; ++i) {
+				std::vector<size_t>& shuffle = shuffles[i-1];
+				size_t& leftDim = leftDims[i-1];
+				size_t& rightDim = rightDims[i-1];
 				size_t leftCount = 0;
-				size_t leftDim = 1, rightDim = 1;
 				size_t fullDim = 1;
 				for(size_t k = 0; k < N+2*stackSize; ++k) {
 					REQUIRE(!_me.tensorObject->nodes[i].erased, "IE");
@@ -285,14 +301,23 @@ namespace xerus {
 				}
 				REQUIRE(fullDim == _me.tensorObject->nodes[i].tensorObject->size, "Uhh");
 				REQUIRE(leftCount == stackSize, "IE");
-				
-				xerus::reshuffle(*_me.tensorObject->nodes[i].tensorObject, *_me.tensorObject->nodes[i].tensorObject, shuffle);
+			}
+			
+			// ...then reshuffle the components, which are independent of each other...
+			misc::parallel_for(numComponents, [&](const size_t _c) {
+				const size_t i = _c+1;
+				xerus::reshuffle(*_me.tensorObject->nodes[i].tensorObject, *_me.tensorObject->nodes[i].tensorObject, shuffles[_c]);
 				if(isOperator) {
-					_me.tensorObject->nodes[i].tensorObject->reinterpret_dimensions({leftDim, _me.tensorObject->dimensions[i-1], _me.tensorObject->dimensions[i-1+numComponents], rightDim});
+					_me.tensorObject->nodes[i].tensorObject->reinterpret_dimensions({leftDims[_c], _me.tensorObject->dimensions[i-1], _me.tensorObject->dimensions[i-1+numComponents], rightDims[_c]});
 				} else {
-					_me.tensorObject->nodes[i].tensorObject->reinterpret_dimensions({leftDim, _me.tensorObject->dimensions[i-1], rightDim});
+					_me.tensorObject->nodes[i].tensorObject->reinterpret_dimensions({leftDims[_c], _me.tensorObject->dimensions[i-1], rightDims[_c]});
 				}
-				
+			});
+			
+			// ...and finally set the new neighbors.
+			for (size_t i = 1; i+1 < numNodes; ++i) {
+				const size_t leftDim = leftDims[i-1];
+				const size_t rightDim = rightDims[i-1];
 				_me.tensorObject->nodes[i].neighbors.clear();
 				_me.tensorObject->nodes[i].neighbors.emplace_back(i-1, i==1 ? 0 : N+1, leftDim, false);
 				_me.tensorObject->nodes[i].neighbors.emplace_back(0, i-1 , _me.tensorObject->dimensions[i-1], true);